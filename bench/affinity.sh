@@ -0,0 +1,23 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: affinity.sh
+# Description: Scaling of CPU bound jobs with and without pinning. AFFINITY_JOBS background md5sum runs (twice the online CPUs by
+#              default) over AFFINITY_MB megabytes (64 by default) are started, then waited for, once as is and once with
+#              @cpu=rr spreading them over the CPUs. @cpu=0 must leave a command allowed on CPU 0 only.
+
+. "$(dirname "$0")/common.sh"
+
+CPUS=$(getconf _NPROCESSORS_ONLN)
+JOBS=${AFFINITY_JOBS:-$((CPUS * 2))}
+MB=${AFFINITY_MB:-64}
+
+head -c $((MB * 1048576)) /dev/urandom > data
+echo '@cpu=0 grep Cpus_allowed_list /proc/self/status' > pinned.sh
+awk -v n="$JOBS" -v prefix="" 'BEGIN { for (i = 0; i < n; i++) { print prefix "md5sum data &" }; print "wait" }' > free.sh
+awk -v n="$JOBS" -v prefix="@cpu=rr " 'BEGIN { for (i = 0; i < n; i++) { print prefix "md5sum data &" }; print "wait" }' > rr.sh
+
+[ "$("$SHELLLITE" -f pinned.sh | awk '{ print $2 }')" = 0 ] || fail "@cpu=0 did not pin the command to CPU 0"
+
+report "$JOBS md5sum of $MB MB on $CPUS CPUs, unpinned" "$(bestMs "$SHELLLITE" -f free.sh)" ms
+report "$JOBS md5sum of $MB MB on $CPUS CPUs, @cpu=rr" "$(bestMs "$SHELLLITE" -f rr.sh)" ms
@@ -0,0 +1,34 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: arena_allocs.sh
+# Description: Checks that steady state parsing allocates nothing. A script gives every line shape once so the line arena grows
+#              to the longest of them, reads the arena allocation counter of stats, runs ARENA_LINES more lines (100000 by
+#              default) of the same shapes and reads the counter again. The lines run in the shell (true, echo, lists and
+#              redirections) so nothing but parsing touches the arenas.
+
+. "$(dirname "$0")/common.sh"
+
+LINES=${ARENA_LINES:-100000}
+
+awk -v lines="$LINES" 'BEGIN {
+    shape[0] = "true a b c d e f g h i j k l m n o p"
+    shape[1] = "true $$ x$$y $$$$ $$-$$"
+    shape[2] = "echo one two three > /dev/null"
+    shape[3] = "true a && true b ; false || true c"
+    shape[4] = "true<  /dev/null   >/dev/null"
+    for (i = 0; i < 5; i++) { print shape[i] }
+    print "stats"
+    for (i = 0; i < lines; i++) { print shape[i % 5] }
+    print "stats"
+}' > lines.sh
+
+"$SHELLLITE" -f lines.sh | awk '/^arena allocations:/ { print $3 }' > counts
+before=$(sed -n 1p counts)
+after=$(sed -n 2p counts)
+[ -n "$before" ] && [ -n "$after" ] || fail "stats printed no arena allocation counter"
+
+report "arena allocations after warm-up" "$before"
+report "arena allocations after $LINES more lines" "$after"
+report "allocations per line" "$(( (after - before) / LINES ))"
+[ "$after" -eq "$before" ] || fail "$((after - before)) arena allocations in $LINES steady state lines, expected 0"
@@ -0,0 +1,22 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: batch_mode.sh
+# Description: Commands per second of batch mode. A script of BATCH_LINES lines (100000 by default) cycling through status, true,
+#              cd . and echo runs with -f and again piped into stdin, both without prompts and with buffered output.
+
+. "$(dirname "$0")/common.sh"
+
+LINES=${BATCH_LINES:-100000}
+
+awk -v n="$LINES" 'BEGIN {
+    shape[0] = "status"; shape[1] = "true"; shape[2] = "cd ."; shape[3] = "echo batch line"
+    for (i = 0; i < n; i++) { print shape[i % 4] }
+}' > script.sh
+
+[ "$("$SHELLLITE" -f script.sh | grep -c '^batch line$')" -eq $((LINES / 4)) ] || fail "the script did not run every line"
+
+file=$(bestMs "$SHELLLITE" -f script.sh)
+piped=$(bestMs sh -c 'cat script.sh | "$0"' "$SHELLLITE")
+report "$LINES lines, shellLite -f script" "$(( LINES * 1000 / (file + 1) ))" "commands/s ($file ms)"
+report "$LINES lines, piped into stdin" "$(( LINES * 1000 / (piped + 1) ))" "commands/s ($piped ms)"
@@ -0,0 +1,50 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: common.sh
+# Description: Helpers sourced by every benchmark and test script of shellLite. Scripts run from the repository root through
+#              make bench or make test, SHELLLITE names the shell under test and every script works in its own scratch
+#              directory, removed when it exits. Times are wall clock milliseconds, the best of BENCH_RUNS runs (3 by default).
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+SHELLLITE=${SHELLLITE:-$ROOT/shellLite}
+BENCH_RUNS=${BENCH_RUNS:-3}
+SCRATCH=$(mktemp -d "${TMPDIR:-/tmp}/shellLite-bench.XXXXXX")
+trap 'rm -rf "$SCRATCH"' EXIT
+cd "$SCRATCH" || exit 1
+
+# The shell must not record benchmark lines in the user's history or read a stale cache
+unset SHELLLITE_HISTORY SHELLLITE_TRACE SHELLLITE_SPLICE SHELLLITE_LAUNCH SHELLLITE_FASTPATH SHELLLITE_POOL
+export SHELLLITE_CACHE_DIR="$SCRATCH/cache"
+
+[ -x "$SHELLLITE" ] || { echo "$SHELLLITE is not built, run make first" >&2; exit 1; }
+
+# nowNs: prints CLOCK_REALTIME in nanoseconds
+nowNs() {
+    date +%s%N
+}
+
+# bestMs command [args...]: runs the command BENCH_RUNS times with its output discarded and prints the fastest run in milliseconds
+bestMs() {
+    best=
+    run=0
+    while [ $run -lt "$BENCH_RUNS" ]; do
+        start=$(nowNs)
+        "$@" > /dev/null 2>&1
+        took=$(( ($(nowNs) - start) / 1000000 ))
+        if [ -z "$best" ] || [ $took -lt $best ]; then best=$took; fi
+        run=$((run + 1))
+    done
+    echo $best
+}
+
+# report label value unit: prints one aligned result line
+report() {
+    printf '  %-48s %10s %s\n' "$1" "$2" "$3"
+}
+
+# fail message: prints the broken claim and ends the script with status 1
+fail() {
+    echo "FAIL: $*" >&2
+    exit 1
+}
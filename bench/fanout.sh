@@ -0,0 +1,23 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: fanout.sh
+# Description: Throughput of >+ against | tee. FANOUT_MB megabytes (1024 by default) of zeros go to two files and /dev/null,
+#              once with head >+ a >+ b > /dev/null, relayed with tee(2) and splice(2), and once with head | tee a b > /dev/null.
+#              Every file must get all the bytes.
+
+. "$(dirname "$0")/common.sh"
+
+MB=${FANOUT_MB:-1024}
+BYTES=$((MB * 1048576))
+
+echo "head -c $BYTES /dev/zero >+ a >+ b > /dev/null" > fanout.sh
+echo "head -c $BYTES /dev/zero | tee a b > /dev/null" > tee.sh
+
+for script in fanout.sh tee.sh; do
+    rm -f a b
+    "$SHELLLITE" -f $script
+    [ "$(wc -c < a)" -eq $BYTES ] && [ "$(wc -c < b)" -eq $BYTES ] || fail "$(cat $script) lost bytes"
+    took=$(bestMs "$SHELLLITE" -f $script)
+    report "$MB MB, $(cut -d ' ' -f 4- $script)" "$(awk -v ms="$took" -v mb="$MB" 'BEGIN { printf "%.2f", mb / 1024 / (ms / 1000) }')" "GB/s ($took ms)"
+done
@@ -0,0 +1,30 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: fastpath.sh
+# Description: In-shell echo, true, false, printf and test against the fork path. A script of FASTPATH_LINES lines (100000 by
+#              default) alternating test -f and echo runs with the fast path and with SHELLLITE_FASTPATH=0, which execs every
+#              command. Both runs must print the same output. The exec'd run is long and is timed once.
+
+. "$(dirname "$0")/common.sh"
+
+LINES=${FASTPATH_LINES:-100000}
+
+touch present
+awk -v n="$LINES" 'BEGIN {
+    for (i = 0; i < n; i += 2) {
+        print (i % 4 == 0 ? "test -f present" : "test -f absent")
+        print "echo line " i " status next"
+    }
+    print "status"
+}' > script.sh
+
+"$SHELLLITE" -f script.sh > fast.out
+start=$(nowNs)
+SHELLLITE_FASTPATH=0 "$SHELLLITE" -f script.sh > exec.out
+exec=$(( ($(nowNs) - start) / 1000000 ))
+cmp -s fast.out exec.out || fail "the fast path printed something else than the real programs"
+
+fast=$(bestMs "$SHELLLITE" -f script.sh)
+report "$LINES lines, fast path" "$fast" ms
+report "$LINES lines, SHELLLITE_FASTPATH=0" "$exec" ms
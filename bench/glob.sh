@@ -0,0 +1,30 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: glob.sh
+# Description: Glob expansion against glob(3) on a directory of GLOB_FILES files (1000000 by default), for one pattern and for
+#              three patterns over the same directory on one line, where the shell reads the directory once. The shell and
+#              glob(3) must find the same number of paths.
+
+. "$(dirname "$0")/common.sh"
+
+FILES=${GLOB_FILES:-1000000}
+GLOB=$ROOT/bench/glob_bench
+ONE='many/*7777*'
+THREE='many/*7777* many/f*1234 many/f0[0-4]?555?'
+
+[ -x "$GLOB" ] || fail "$GLOB is not built, run make bench"
+mkdir many
+(cd many && seq -f 'f%07g' 1 "$FILES" | xargs touch)
+
+set -f    # the patterns reach shellLite and glob_bench as typed
+for patterns in "$ONE" "$THREE"; do
+    echo "echo $patterns > words" > count.sh
+    echo "true $patterns" > expand.sh
+    "$SHELLLITE" -f count.sh
+    [ "$(wc -w < words)" -eq "$("$GLOB" $patterns)" ] || fail "the shell and glob(3) disagree on $patterns"
+
+    shell=$(( $(bestMs "$SHELLLITE" -f expand.sh) - $(bestMs "$SHELLLITE" -f /dev/null) ))
+    report "$FILES files, $patterns" "$shell" "ms shell"
+    report "" "$(bestMs "$GLOB" $patterns)" "ms glob(3)"
+done
@@ -0,0 +1,30 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: glob_bench.c
+* Description: This is the glob(3) side of the glob benchmark of the shellLite shell. Every argument is expanded with glob(3),
+*              sorted like the shell sorts, and the number of paths all the patterns matched is printed, an unmatched pattern
+*              counting as itself like a word the shell keeps as typed.
+*                  glob_bench pattern...
+* Citations:
+*         1. glob(3) Linux manual page, Assisted with the flags.
+*/
+#include <stdio.h>
+#include <glob.h>
+
+int main(int argc, char* argv[]) {
+    glob_t matches;
+    size_t total = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (glob(argv[i], 0, NULL, &matches) == 0) {
+            total += matches.gl_pathc;
+        } else {
+            total++;    //GLOB_NOMATCH, the shell keeps the word
+        }
+        globfree(&matches);
+    }
+    printf("%zu\n", total);
+    return 0;
+}
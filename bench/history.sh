@@ -0,0 +1,50 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: history.sh
+# Description: Startup time and search latency with a history of HISTORY_ENTRIES commands (1000000 by default). Startup is an
+#              empty script with and without SHELLLITE_HISTORY. Substring and prefix search are timed on first use, which splits
+#              the file into lines and, for prefix search, sorts the index, and again once the index exists. Then a !prefix
+#              recall of an old command. Every step includes the /bin/date that stamps it, about 1 ms. Prefix search must find
+#              as many commands as grep.
+
+. "$(dirname "$0")/common.sh"
+
+ENTRIES=${HISTORY_ENTRIES:-1000000}
+
+awk -v n="$ENTRIES" 'BEGIN { for (i = 0; i < n; i++) { print "echo item" i % 1000 " number " i } }' > history
+expected=$(grep -c '^echo item7 number 7' history)
+cat > search.sh <<'SCRIPT'
+/bin/date +%s%N > stamp1
+history -s number 77777
+/bin/date +%s%N > stamp2
+history -s number 77777
+/bin/date +%s%N > stamp3
+echo ==
+history -p echo item7 number 7
+/bin/date +%s%N > stamp4
+echo ==
+history -p echo item7 number 7
+/bin/date +%s%N > stamp5
+!echo item3 number 3
+/bin/date +%s%N > stamp6
+SCRIPT
+: > empty.sh
+
+report "$ENTRIES entries, startup and exit" "$(SHELLLITE_HISTORY=history bestMs "$SHELLLITE" -f empty.sh)" ms
+report "no history, startup and exit" "$(bestMs "$SHELLLITE" -f empty.sh)" ms
+
+SHELLLITE_HISTORY=history "$SHELLLITE" -f search.sh > out
+cat stamp1 stamp2 stamp3 stamp4 stamp5 stamp6 > stamps
+found=$(awk '/^==$/ { section++; next } section == 1 && / echo item7 number 7/ { n++ } END { print n + 0 }' out)
+[ "$found" -eq "$expected" ] || fail "history -p found $found commands, grep found $expected"
+
+# step label: reports the time between stamp number step and the next one
+step() {
+    report "$2" "$(awk -v at="$1" 'NR == at { start = $1 } NR == at + 1 { printf "%.2f", ($1 - start) / 1e6 }' stamps)" ms
+}
+step 1 "history -s, first use (splits the file)"
+step 2 "history -s, again"
+step 3 "history -p, first use (sorts the index)"
+step 4 "history -p, again"
+step 5 "!prefix recall of an old command"
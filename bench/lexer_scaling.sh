@@ -0,0 +1,28 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: lexer_scaling.sh
+# Description: Checks that the lexer is linear in the line length. For every size in LEXER_MB (1 4 16 by default) three lines of
+#              that many megabytes of "a$$ " words are lexed, the ARG_MAX check then rejects them so nothing runs. The time per
+#              megabyte of the largest size may be at most 3 times that of the smallest, a quadratic lexer would be 16 times.
+
+. "$(dirname "$0")/common.sh"
+
+SIZES=${LEXER_MB:-1 4 16}
+first=
+last=
+
+: > empty.sh
+empty=$(bestMs "$SHELLLITE" -f empty.sh)
+for mb in $SIZES; do
+    : > lines.sh
+    for line in 1 2 3; do
+        { printf 'true '; head -c $((mb * 1048576 / 4)) /dev/zero | sed 's/\x0/a$$ /g'; echo; } >> lines.sh
+    done
+    took=$(( $(bestMs "$SHELLLITE" -f lines.sh) - empty ))
+    perMb=$(awk -v ms="$took" -v mb="$mb" 'BEGIN { printf "%.2f", ms / (3 * mb) }')
+    report "3 lines of $mb MB, a\$\$ words" "$took" "ms ($perMb ms per MB)"
+    [ -n "$first" ] || first=$perMb
+    last=$perMb
+done
+awk -v a="$first" -v b="$last" 'BEGIN { exit !(b <= 3 * a + 1) }' || fail "lexing got slower per MB as lines grew: $first then $last ms per MB"
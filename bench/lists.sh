@@ -0,0 +1,34 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: lists.sh
+# Description: One && chain on a line against the same commands on separate lines. LIST_COMMANDS true commands (10000 by default)
+#              run in the shell, LIST_EXEC_COMMANDS /bin/true commands (2000 by default) are launched. Each chain ends with an
+#              echo that must print, and a chain broken by false must stop there.
+
+. "$(dirname "$0")/common.sh"
+
+COMMANDS=${LIST_COMMANDS:-10000}
+EXECS=${LIST_EXEC_COMMANDS:-2000}
+
+# script name command count separator: writes count commands joined by separator, then an echo
+chain() {
+    awk -v cmd="$2" -v n="$3" -v sep="$4" 'BEGIN {
+        for (i = 0; i < n; i++) { printf "%s%s", cmd, sep }
+        print "echo chain done"
+    }' > "$1"
+}
+
+chain chain.sh true "$COMMANDS" " && "
+chain lines.sh true "$COMMANDS" "\n"
+chain exec_chain.sh /bin/true "$EXECS" " && "
+chain exec_lines.sh /bin/true "$EXECS" "\n"
+echo "true && false && echo broken ; echo after" > broken.sh
+
+[ "$("$SHELLLITE" -f chain.sh)" = "chain done" ] || fail "the && chain did not reach its end"
+[ "$("$SHELLLITE" -f broken.sh)" = "after" ] || fail "false did not stop the && chain"
+
+report "$COMMANDS true, one && chain" "$(bestMs "$SHELLLITE" -f chain.sh)" ms
+report "$COMMANDS true, separate lines" "$(bestMs "$SHELLLITE" -f lines.sh)" ms
+report "$EXECS /bin/true, one && chain" "$(bestMs "$SHELLLITE" -f exec_chain.sh)" ms
+report "$EXECS /bin/true, separate lines" "$(bestMs "$SHELLLITE" -f exec_lines.sh)" ms
@@ -0,0 +1,27 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: pipeline.sh
+# Description: Throughput of | pipelines against the temp file workaround they replace. PIPE_MB megabytes (1024 by default) of
+#              zeros go through head | cat | wc -c, through the same pipeline with the shell relaying between the stages with
+#              splice (SHELLLITE_SPLICE=1), and through head > file, cat < file > file, wc -c < file. Every way must count the
+#              same bytes.
+
+. "$(dirname "$0")/common.sh"
+
+MB=${PIPE_MB:-1024}
+BYTES=$((MB * 1048576))
+
+echo "head -c $BYTES /dev/zero | cat | wc -c" > pipe.sh
+printf 'head -c %s /dev/zero > t1\ncat < t1 > t2\nwc -c < t2\nrm t1 t2\n' "$BYTES" > files.sh
+
+[ "$("$SHELLLITE" -f pipe.sh)" -eq $BYTES ] || fail "the pipeline lost bytes"
+[ "$(SHELLLITE_SPLICE=1 "$SHELLLITE" -f pipe.sh 2>/dev/null | tail -n 1)" -eq $BYTES ] || fail "the splice relay lost bytes"
+[ "$("$SHELLLITE" -f files.sh)" -eq $BYTES ] || fail "the temp files lost bytes"
+
+pipe=$(bestMs "$SHELLLITE" -f pipe.sh)
+relay=$(SHELLLITE_SPLICE=1 bestMs "$SHELLLITE" -f pipe.sh)
+files=$(bestMs "$SHELLLITE" -f files.sh)
+report "$MB MB, head | cat | wc -c" "$(awk -v ms="$pipe" -v mb="$MB" 'BEGIN { printf "%.2f", mb / 1024 / (ms / 1000) }')" "GB/s ($pipe ms)"
+report "$MB MB, same with the splice relay" "$(awk -v ms="$relay" -v mb="$MB" 'BEGIN { printf "%.2f", mb / 1024 / (ms / 1000) }')" "GB/s ($relay ms)"
+report "$MB MB, through two temp files" "$(awk -v ms="$files" -v mb="$MB" 'BEGIN { printf "%.2f", mb / 1024 / (ms / 1000) }')" "GB/s ($files ms)"
@@ -0,0 +1,29 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: reap.sh
+# Description: Reaping stress test. REAP_JOBS background sleep 0 jobs (10000 by default) are started back to back, then wait
+#              returns once all of them are reaped. Reported are the launch time, the time from the last launch until wait
+#              returns, and the CPU the shell itself used, from /proc/<pid>/stat. stats must count every job as reaped.
+
+. "$(dirname "$0")/common.sh"
+
+JOBS=${REAP_JOBS:-10000}
+
+awk -v n="$JOBS" 'BEGIN {
+    print "/bin/date +%s%N > started"
+    for (i = 0; i < n; i++) { print "sleep 0 &" }
+    print "/bin/date +%s%N > launched"
+    print "wait"
+    print "/bin/date +%s%N > reaped"
+    print "cat /proc/$$/stat > stat"
+    print "stats"
+}' > jobs.sh
+
+reaped=$("$SHELLLITE" -f jobs.sh 2>&1 | awk '/^background jobs reaped:/ { print $4 }')
+[ "$reaped" = "$JOBS" ] || fail "stats counted $reaped reaped jobs, expected $JOBS"
+
+ticks=$(getconf CLK_TCK)
+report "$JOBS jobs, launch" "$(( ($(cat launched) - $(cat started)) / 1000000 ))" ms
+report "last launch until every job is reaped" "$(( ($(cat reaped) - $(cat launched)) / 1000000 ))" ms
+report "shell CPU, user + sys" "$(awk -v hz="$ticks" '{ printf "%d", ($14 + $15) * 1000 / hz }' stat)" ms
@@ -0,0 +1,17 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: run.sh
+# Description: Runs every benchmark script in bench/, or the ones named on the command line, and exits with status 1 if any of
+#              them reports a broken claim. Used by make bench, BENCH_RUNS and the size variables of each script shrink a run.
+
+cd "$(dirname "$0")" || exit 1
+failed=0
+if [ $# -eq 0 ]; then
+    set -- $(ls *.sh | grep -v -e '^common\.sh$' -e '^run\.sh$')
+fi
+for script in "$@"; do
+    echo "== $script"
+    sh "./$script" || failed=$((failed + 1))
+done
+[ $failed -eq 0 ] || { echo "$failed benchmark(s) failed" >&2; exit 1; }
@@ -0,0 +1,26 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: serve.sh
+# Description: Load test of --serve against a fork per request. serve_client sends SERVE_REQUESTS requests (2000 by default) one
+#              after the other over one connection, for the in-shell echo and for /bin/true, then runs /bin/true through a
+#              fresh /bin/sh -c per request. Request rate and latency percentiles are reported for each.
+
+. "$(dirname "$0")/common.sh"
+
+REQUESTS=${SERVE_REQUESTS:-2000}
+CLIENT=$ROOT/bench/serve_client
+
+[ -x "$CLIENT" ] || fail "$CLIENT is not built, run make bench"
+"$SHELLLITE" --serve "$SCRATCH/sock" &
+server=$!
+trap 'kill $server; rm -rf "$SCRATCH"' EXIT
+tries=0
+while [ ! -S "$SCRATCH/sock" ] && [ $tries -lt 100 ]; do sleep 0.05; tries=$((tries + 1)); done
+
+echoes=$("$CLIENT" "$SCRATCH/sock" "$REQUESTS" "echo hello") || fail "serve echo requests failed"
+trues=$("$CLIENT" "$SCRATCH/sock" "$REQUESTS" /bin/true) || fail "serve /bin/true requests failed"
+forks=$("$CLIENT" -fork "$REQUESTS" /bin/true) || fail "fork requests failed"
+report "serve, echo (in the shell)" "$echoes"
+report "serve, /bin/true" "$trues"
+report "/bin/sh -c /bin/true per request" "$forks"
@@ -0,0 +1,171 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: serve_client.c
+* Description: This is the load test client for the server mode of the shellLite shell. It sends one command line N times over a
+*              single connection, waiting for each frame before the next line, and prints the request rate and the latency
+*              percentiles. With -fork instead of a socket path every request is a fresh /bin/sh -c command with its output
+*              read from a pipe, the fork per request setup --serve replaces.
+*                  serve_client socket N command
+*                  serve_client -fork N command
+* Citations:
+*         1. unix(7) Linux manual page, Assisted with connecting to the socket.
+*/
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define HEADER_MAX 64    //Longest frame header, three numbers and the newline
+
+/*            nowNs
+ * Description: Reads CLOCK_MONOTONIC.
+ * Parameters: void
+ * Returns: nanoseconds
+ * Preconditions: N/A
+ */
+static long long nowNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*            readFully
+ * Description: Reads exactly length bytes from fd into buffer, or discards them when buffer is NULL.
+ * Parameters: int fd, char* buffer, size_t length
+ * Returns: 0 on success, -1 on error or end of file
+ * Preconditions: fd >= 0
+ */
+static int readFully(int fd, char* buffer, size_t length) {
+    char scratch[65536];
+    ssize_t got;
+
+    while (length > 0) {
+        got = read(fd, buffer != NULL ? buffer : scratch, buffer != NULL || length < sizeof(scratch) ? length : sizeof(scratch));
+        if (got == -1 && errno == EINTR) { continue; }
+        if (got <= 0) { return -1; }
+        if (buffer != NULL) { buffer += got; }
+        length -= got;
+    }
+    return 0;
+}
+
+/*            serveRequest
+ * Description: Sends line to the server and reads its frame: a "<status> <stdout bytes> <stderr bytes>" header, then the output.
+ * Parameters: int sock, char* line, size_t length
+ * Returns: status of the command, -1 if the connection failed
+ * Preconditions: sock is connected, line ends with a newline
+ */
+static int serveRequest(int sock, char* line, size_t length) {
+    char header[HEADER_MAX];
+    size_t used = 0;
+    long status, outBytes, errBytes;
+
+    if (write(sock, line, length) != (ssize_t)length) { return -1; }
+    do {
+        if (used == sizeof(header) - 1 || readFully(sock, header + used, 1) == -1) { return -1; }
+    } while (header[used++] != '\n');
+    header[used] = '\0';
+    if (sscanf(header, "%ld %ld %ld", &status, &outBytes, &errBytes) != 3) { return -1; }
+    if (readFully(sock, NULL, outBytes + errBytes) == -1) { return -1; }
+    return (int)status;
+}
+
+/*            forkRequest
+ * Description: Runs command with /bin/sh -c, reading its stdout and stderr from a pipe until it exits.
+ * Parameters: char* command
+ * Returns: exit status of the command, -1 if it could not be started
+ * Preconditions: command != NULL
+ */
+static int forkRequest(char* command) {
+    char buffer[65536];
+    int fds[2];
+    int status;
+    pid_t pid;
+
+    if (pipe(fds) == -1) { return -1; }
+    pid = fork();
+    if (pid == -1) { close(fds[0]); close(fds[1]); return -1; }
+    if (pid == 0) {
+        dup2(fds[1], 1);
+        dup2(fds[1], 2);
+        close(fds[0]);
+        close(fds[1]);
+        execl("/bin/sh", "sh", "-c", command, (char*)NULL);
+        _exit(127);
+    }
+    close(fds[1]);
+    while (read(fds[0], buffer, sizeof(buffer)) > 0) { }
+    close(fds[0]);
+    if (waitpid(pid, &status, 0) == -1) { return -1; }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+/*            compareTimes
+ * Description: qsort comparison of two latencies.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at long long
+ */
+static int compareTimes(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char* argv[]) {
+    struct sockaddr_un address;
+    long long* times;              //Latency of every request
+    long long began, start;
+    char* line;                    //command with a newline, as the server reads it
+    size_t length;
+    int sock = -1;
+    int requests, i;
+
+    if (argc != 4 || (requests = atoi(argv[2])) < 1) {
+        fprintf(stderr, "Usage: serve_client socket|-fork N command\n");
+        return 2;
+    }
+    length = strlen(argv[3]) + 1;
+    line = malloc(length + 1);
+    times = malloc(requests * sizeof(long long));
+    if (line == NULL || times == NULL) { perror("malloc() error\n"); return 1; }
+    sprintf(line, "%s\n", argv[3]);
+
+    if (strcmp(argv[1], "-fork") != 0) {
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+        sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock == -1 || connect(sock, (struct sockaddr*)&address, sizeof(address)) == -1) {
+            perror("connect() error\n");
+            return 1;
+        }
+    }
+
+    began = nowNs();
+    for (i = 0; i < requests; i++) {
+        start = nowNs();
+        if ((sock != -1 ? serveRequest(sock, line, length) : forkRequest(argv[3])) == -1) {
+            fprintf(stderr, "serve_client: request %d failed\n", i + 1);
+            return 1;
+        }
+        times[i] = nowNs() - start;
+    }
+    began = nowNs() - began;
+
+    qsort(times, requests, sizeof(long long), compareTimes);
+    printf("%.0f req/s, p50 %.1f us, p99 %.1f us, max %.1f us\n", requests / (began / 1e9), times[requests / 2] / 1e3,
+        times[(int)(requests * 0.99)] / 1e3, times[requests - 1] / 1e3);
+
+    if (sock != -1) { close(sock); }
+    free(line);
+    free(times);
+    return 0;
+}
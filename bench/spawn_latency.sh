@@ -0,0 +1,34 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: spawn_latency.sh
+# Description: Spawn to exit latency of /bin/true with posix_spawn and with the fork fallback (SHELLLITE_LAUNCH=fork) at several
+#              sizes of the shell. The shell is grown by reading the same long line twice before the commands: the line reader
+#              and the line arena keep their size, and the second read touches the arena block the first one left. The line is
+#              rejected by the ARG_MAX check, so it runs nothing. HEAP_LINE_MB lists the line sizes (0 32 128 by default), the
+#              shell's VmRSS is reported for each. SPAWN_LINES commands (2000 by default) are timed, less a run of the same
+#              script without them.
+
+. "$(dirname "$0")/common.sh"
+
+SIZES=${HEAP_LINE_MB:-0 32 128}
+LINES=${SPAWN_LINES:-2000}
+export SHELLLITE_FASTPATH=0    # /bin/true must really be launched
+
+for mb in $SIZES; do
+    : > grow.sh
+    if [ "$mb" -gt 0 ]; then
+        for line in 1 2; do
+            { printf 'true '; head -c $((mb * 1048576)) /dev/zero | tr '\0' x; echo; } >> grow.sh
+        done
+    fi
+    { cat grow.sh; echo 'grep VmRSS /proc/$$/status'; } > base.sh
+    { cat grow.sh; awk -v n="$LINES" 'BEGIN { for (i = 0; i < n; i++) { print "/bin/true" } }'; } > run.sh
+    rss=$("$SHELLLITE" -f base.sh 2>/dev/null | awk '/VmRSS/ { printf "%d MB", $2 / 1024 }')
+
+    for engine in spawn fork; do
+        base=$(SHELLLITE_LAUNCH=$engine bestMs "$SHELLLITE" -f base.sh)
+        run=$(SHELLLITE_LAUNCH=$engine bestMs "$SHELLLITE" -f run.sh)
+        report "$engine, shell VmRSS $rss" "$(( (run - base) * 1000 / LINES ))" "us per command"
+    done
+done
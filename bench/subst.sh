@@ -0,0 +1,22 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: subst.sh
+# Description: Throughput of $(...) capture and splitting. $(cat file) reads SUBST_MB megabytes (50 by default) of short lines,
+#              the words are then rejected by the ARG_MAX check so nothing runs. A substitution small enough to run must give
+#              the file's word count.
+
+. "$(dirname "$0")/common.sh"
+
+MB=${SUBST_MB:-50}
+
+yes substituted | head -c $((MB * 1048576)) > big
+yes substituted | head -n 1000 > small
+echo 'true $(cat big)' > big.sh
+echo 'true' > empty.sh
+echo 'echo $(cat small)' > small.sh
+
+[ "$("$SHELLLITE" -f small.sh | wc -w)" -eq 1000 ] || fail "\$(cat small) did not give 1000 words"
+
+took=$(( $(bestMs "$SHELLLITE" -f big.sh) - $(bestMs "$SHELLLITE" -f empty.sh) ))
+report "\$(cat $MB MB), capture and split" "$(awk -v ms="$took" -v mb="$MB" 'BEGIN { printf "%d", mb / (ms / 1000) }')" "MB/s ($took ms)"
@@ -0,0 +1,36 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: trace.sh
+# Description: Cost of the tracer. The same scripts run under shellLite without SHELLLITE_TRACE, under bench/shellLite-notrace,
+#              built with -DSHELLLITE_NO_TRACE so the trace points are compiled out, and with tracing on. TRACE_LINES lines of
+#              true (200000 by default) pass only the parse point, TRACE_EXEC_LINES lines of /bin/true (2000 by default) pass
+#              every point. Tracing off may cost at most TRACE_SLACK percent (10 by default) over the compiled out build, and
+#              the traced run must leave a JSON array with a span per /bin/true.
+
+. "$(dirname "$0")/common.sh"
+
+LINES=${TRACE_LINES:-200000}
+EXECS=${TRACE_EXEC_LINES:-2000}
+SLACK=${TRACE_SLACK:-10}
+NOTRACE=$ROOT/bench/shellLite-notrace
+BENCH_RUNS=$((BENCH_RUNS + 2))    # the difference is small, take the best of more runs
+
+[ -x "$NOTRACE" ] || fail "$NOTRACE is not built, run make bench"
+awk -v n="$LINES" 'BEGIN { for (i = 0; i < n; i++) { print "true" } }' > parse.sh
+awk -v n="$EXECS" 'BEGIN { for (i = 0; i < n; i++) { print "/bin/true" } }' > exec.sh
+
+SHELLLITE_TRACE=trace.json "$SHELLLITE" -f exec.sh
+[ "$(head -c 1 trace.json)" = "[" ] && [ "$(tail -c 3 trace.json | tr -d '\n')" = "]" ] || fail "the trace is not a JSON array"
+[ "$(grep -c '"cat":"foreground"' trace.json)" -eq "$EXECS" ] || fail "the trace is missing command spans"
+
+for script in parse.sh exec.sh; do
+    lines=$(wc -l < $script)
+    off=$(bestMs "$SHELLLITE" -f $script)
+    out=$(bestMs "$NOTRACE" -f $script)
+    on=$(SHELLLITE_TRACE=trace.json bestMs "$SHELLLITE" -f $script)
+    report "$lines lines of $(head -n 1 $script), compiled out" "$out" ms
+    report "$lines lines of $(head -n 1 $script), tracing off" "$off" ms
+    report "$lines lines of $(head -n 1 $script), tracing on" "$on" ms
+    [ $((off * 100)) -le $((out * (100 + SLACK) + 500)) ] || fail "tracing off took $off ms against $out ms compiled out"
+done
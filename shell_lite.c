@@ -1,157 +1,210 @@
 /* Author: David Eaton
  * Date: 05/07/2020
- * Last Revised: 05/19/2020
+ * Last Revised: 10/18/2026
  * File Name: shell_lite.c
  * Description: This program creates a light-weight shell for a linux environment using C. The shell supports 3 built-in commands: exit, cd, status. These 3 built-in commands are
  * 		handled by the shell itself and do not support manual background/foreground functionality. For non-built-in commands both background and foreground
- * 		functionality is supported. Comments starting with # are supported as well. This program can support command lines with a maximum of 2048 characters and a 
- * 		maximum of 512 arguments(command [arg1 arg2 ...arg512]). There is no support for quoting(arguments with spaces), and no support for the | operator. SIGINT
- * 		terminates foreground commands only, SIGTSTP turns off/on foreground-only mode.
+ * 		functionality is supported. Comments starting with # are supported as well. Command lines and argument lists grow as needed, only a line whose
+ * 		arguments exceed the system's ARG_MAX is rejected. There is no support for quoting(arguments with spaces). SIGINT
+ * 		terminates foreground commands only, SIGTSTP turns off/on foreground-only mode. The main loop waits in epoll on the input and on the job
+ * 		table's signalfd, so finished background jobs and mode changes are reported while the prompt is waiting and no signal handler runs.
  * Citations:
  * 		1. "Sending a Signal to Another Process: System Call kill()" http://www.csl.mtu.edu/cs4411.ck/www/NOTES/signal/kill.html, Assisted with kill()
  * 		2. Brewster, Benjamin "Signals", Assisted with sending signals to processes.
  * 		3. "What is the best way in C to convert a number to a string?" https://www.geeksforgeeks.org/what-is-the-best-way-in-c-to-convert-a-number-to-a-string/,
  * 		    Assisted with converting a number to a string 
+ * 		4. epoll(7) Linux manual page, Assisted with the event loop.
  */
 
 #include <stdio.h>
 #include "shell_lite_builtins.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_input.h"
+#include "shell_lite_stats.h"
+#include "shell_lite_pool.h"
+#include "shell_lite_serve.h"
+#include "shell_lite_trace.h"
+#include "shell_lite_history.h"
+#include "shell_lite_heredoc.h"
+#include <sys/epoll.h>
 
-#define BUFFER_MAX 2048
 #define COMMAND_PROMPT_MAX 2
-#define ARG_MAX  512 
-#define BACKGROUND_MAX 1000
+#define EVENTS_MAX 2		//Input and the signalfd
 
-int background_switch = 1;	//Switch for background functionality, 1 means enabled and 0 means disabled. Default is enabled.
-
-/* Signal Handler Function Prototypes */
-void backgroundSwitch(int);         //This function enables/disables background functionality
-
-int main() {
+int main(int argc, char* argv[]) {
 	/* Variables needed by the shell */
 	int exitFlag = 0;					//Signals the prompt for command loop to exit.
+	int inputFd = STDIN_FILENO;				//Commands are read from here, a script given with -f replaces stdin
+	int interactive = 1;					//1 when commands come from a terminal, enables the prompt
+	int prompted = 0;					//1 once the prompt for the line being read has been shown
+	int alwaysReady = 0;					//1 if epoll cannot watch the input(a regular file), reads never block then
+	int epollFd;						//Waits on the input and the job table's signalfd
+	struct epoll_event event;				//Registration of one descriptor
+	struct epoll_event events[EVENTS_MAX];			//Descriptors reported ready by epoll_wait
+	int ready;						//Number of entries in events
 	char commandPrompt[COMMAND_PROMPT_MAX] = ": ";		//Command line prompt
-	char* inputBuffer = NULL; 				//Stores user command line input
-	char* expandedInput = NULL;				//Stores processed inputBuffer with expanded $$ 
-	size_t bufferSize = 0;					//Holds size of allocated buffer from getline
-	int numCharsEntered = -1;				//Holds the number returned from getline(the number of characters entered), used for error checking.
+	char* inputBuffer = NULL; 				//Stores user command line input, points into reader's block buffer
+	struct lineReader reader;				//Reads input in large blocks and hands out one line at a time
+	ssize_t numCharsEntered = -1;				//Holds the number returned from takeLine(the number of characters entered), used for error checking.
 	int count = -1;						//Holds the count of initialized elements in arrayOfArgs
 	char** arrayOfArgs;					//Holds an array of parsed arguments from the inputBuffer	
 	int  i;
+	long long lineRead = 0;					//Time takeLine returned the current line, for the parse phase of stats
+	long long parsed = 0;					//Time parseBuffer returned, end of the parse phase
 	pid_t PID = getpid();					//Stores shell's PIDi
 	char sPID[50]; memset(sPID, '\0', sizeof(sPID));	//string version for variable expansion
 	sprintf(sPID, "%d", (int)PID);				//Convert to string
 
+	/* Batch mode: commands come from a script given with -f or from a stdin that is not a terminal. No prompt is shown and shell output is
+	 * fully buffered, it is flushed before a command is launched and at exit. */
+	if (argc == 3 && strcmp(argv[1], "-f") == 0) {
+		inputFd = open(argv[2], O_RDONLY | O_CLOEXEC);
+		if (inputFd == -1) { perror("open() error\n"); return 1; }
+	} else if (argc == 3 && strcmp(argv[1], "--serve") == 0) {
+		return serveCommands(argv[2]);	//Server mode, one shell per connection
+	} else if (argc != 1) {
+		fprintf(stderr, "Usage: %s [-f script | --serve socket]\n", argv[0]);
+		return 1;
+	}
+	interactive = (inputFd == STDIN_FILENO && isatty(STDIN_FILENO));
+	if (interactive) {
+		setvbuf(stdout, NULL, _IOLBF, 0);	//Every complete line reaches the terminal right away
+	} else {
+		setvbuf(stdout, NULL, _IOFBF, INPUT_BLOCK_SIZE);
+	}
+	initLineReader(&reader, inputFd);
+	initTrace();						//Timeline of the shell and its commands, only with SHELLLITE_TRACE set
+	initHistory(interactive);				//Maps the history file, scripts only keep history with SHELLLITE_HISTORY set
+
 	struct process* lastFP= malloc(sizeof(struct process));		//Stores most recent foreground process 
 	initProcess(lastFP);	//Initialize lastFP	
 
-	struct process* backgroundPs[BACKGROUND_MAX];		//Stores background processes 
-	int bCount = 0;						//count for background processes	
+	/* SIGCHLD, SIGINT and SIGTSTP are blocked here and read from the job table's signalfd: SIGINT reaches foreground commands through the
+	 * terminal, SIGTSTP toggles jobs.foregroundOnly. */
+	struct jobTable jobs;					//Stores background processes and every child being waited on
+	initJobTable(&jobs);
+	initPool();						//Pre-forked launch helpers, only with SHELLLITE_POOL set
+
+	struct arena lineArena;					//Holds the parsed arguments of one command line
+	initArena(&lineArena, ARENA_START_SIZE);
+
+	/* Event loop setup, the input is read only when epoll reports it readable */
+	epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if (epollFd == -1) { perror("epoll_create1() error\n"); return 1; }
+	event.events = EPOLLIN;
+	event.data.fd = jobs.sigFd;
+	epoll_ctl(epollFd, EPOLL_CTL_ADD, jobs.sigFd, &event);
+	event.data.fd = inputFd;
+	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, inputFd, &event) == -1) {
+		if (errno != EPERM) { perror("epoll_ctl() error\n"); return 1; }
+		alwaysReady = 1;	//Regular files are always readable and cannot be watched
+	}
+
+	/* Handle complete lines as soon as they are buffered, otherwise report job events, prompt and wait for input or a signal */
+	while (exitFlag == 0) {
+		numCharsEntered = takeLine(&reader, &inputBuffer);	//Next line already in the block buffer, no read
+		if (numCharsEntered > 0) {
+			lineRead = statsNow();
+			count = 0;
 
-	/* Signal Handler Setup */
-	struct sigaction SIGTSTP_action = {0}, SIGINT_action = {0};	//Completely initialize both sigaction structs to be empty
-		
-	SIGTSTP_action.sa_handler = backgroundSwitch;		//SIGTSTP should disable background functionality of the shell.
-	sigfillset(&SIGTSTP_action.sa_mask);			//Block all signals while handler is being executed
-	SIGTSTP_action.sa_flags = 0;				//No special flags
-	sigaction(SIGTSTP, &SIGTSTP_action, NULL);		//Register signal handler for SIGTSTP
+			/* Release the previous line's expansion and arguments in one step */
+			arenaReset(&lineArena);
+
+			/* !!, !N and !prefix recall a command, the recalled text is what history keeps */
+			if (inputBuffer[0] == '!' && inputBuffer[1] != '\0' && inputBuffer[1] != ' ') {
+				numCharsEntered = recallHistory(&inputBuffer, numCharsEntered);
+				if (numCharsEntered == -1) { prompted = 0; continue; }
+			}
+			addHistory(inputBuffer, numCharsEntered);
+
+			if (inputBuffer[0] != '#') {		//Make sure input is not a comment	
+				/* Parse input from user, expanding all cases of $$ on the way. & is ignored in foreground-only mode */
+				arrayOfArgs = parseBuffer(inputBuffer, numCharsEntered, sPID, &count, !jobs.foregroundOnly, &lineArena, &jobs);	//count is 0 if the arguments exceed ARG_MAX
+				parsed = statsSince(STATS_PARSE, lineRead);
+				if (traceEnabled) { traceSpan("parse", lineRead, parsed, 0); }
+
+				/* Here-document bodies are the lines that follow, read them before anything runs */
+				if (count > 0) {
+					readHereDocuments(arrayOfArgs, count, &reader, sPID, interactive, &lineArena);
+				}
+
+			/*	// Uncomment to see parsed arguments 
+				printf("\n\n");
+				fflush(stdout);
+				for(i = 0; i < count; i++) {
+					printf("Argument %d: %s\n", i, arrayOfArgs[i]);
+					fflush(stdout);
+				}
 
-	SIGINT_action.sa_handler = SIG_IGN;			//Smallsh and background processes should ignore SIGINT
-	sigaction(SIGINT, &SIGINT_action, NULL);
+			*/	
+			}
 
-	/* Create while loop to continously prompt user for commands and arguments. End while loop upon recieving the comand exit */
-	do {
+			/* Command Handler via switch statement */
+			if (count > 0) {
+				exitFlag = commandHandler(arrayOfArgs, &count, lastFP, &jobs);
+			}
+			prompted = 0;
+			continue;
+		}
 
-		while (count <= 0) {	//If nonblank input is recieved then loop will break, else keep prompting for command
+		if (reader.eof) {
+			if (interactive) {
+				reader.eof = 0;		//CTRL-D at the terminal is ignored, keep prompting
+			} else {
+				exitShell(&jobs);	//End of script behaves like exit, kill background running processes
+				exitFlag = 1;
+				continue;
+			}
+		}
 
-			/* Check background process */
-			backgroundChecker(backgroundPs, &bCount);
+		/* Check background process, messages push the prompt down so it is shown again */
+		if (backgroundChecker(&jobs) > 0) {
+			prompted = 0;
+		}
+		refillPool();					//Replace helpers used by the last line while the user types
 
-			/* Prompt user for command via ':' */
+		/* Prompt user for command via ':' */
+		if (interactive && !prompted) {
 			if (write(STDOUT_FILENO, commandPrompt, COMMAND_PROMPT_MAX) != COMMAND_PROMPT_MAX) {
 				write(STDERR_FILENO, "Problem writing commandPrompt to standard out\n", 46);	//Write error to stderror if not able to write commandPrompt to stdout 
 				return -1;
 			}
-			fflush(stdout);		//Flush out stdout to force output to screen
-		
-			/* Get user input */
-			numCharsEntered = getline(&inputBuffer, &bufferSize, stdin);	//Read input into inputBuffer from stdin, dynamically create space required.
-			if (numCharsEntered == -1) {
-				clearerr(stdin);
-			} else {
-				if (inputBuffer[0] != '#') {		//Make sure input is not a comment	
-					/* Check and expand all cases of $$ */
-					expandedInput = variableExpansion(inputBuffer, sPID);
-					
-					/* Parse input from user */
-					arrayOfArgs = parseBuffer(expandedInput, &count, BUFFER_MAX, ARG_MAX, background_switch);
-
-				/*	// Uncomment to see parsed arguments 
-					printf("\n\n");
-					fflush(stdout);
-					for(i = 0; i < count; i++) {
-						printf("Argument %d: %s\n", i, arrayOfArgs[i]);
-						fflush(stdout);
-					}
-
-				*/	
-
-					/* Validate that the Prompt is a max of 2048 characters and a max of 512 arguments */
-					if (count > ARG_MAX || strlen(inputBuffer) > BUFFER_MAX) { 
-						count = 0;	//Reset count to zero to repromt for a command 
-						fprintf(stderr, "Error, commands should be a max of %d characters and a max of %d arguments\n", BUFFER_MAX, ARG_MAX); 
-					}
-					
-				}
-
-					free(inputBuffer);	//Free inputBuffer to avoid memory leaks
-					inputBuffer = NULL;
-					free(expandedInput);	//Free expandedInput
-					expandedInput = NULL;
-				
+			prompted = 1;
+		}
+
+		if (alwaysReady) {
+			fillLineReader(&reader);	//Interrupted reads are retried on the next pass
+			continue;
+		}
+
+		ready = epoll_wait(epollFd, events, EVENTS_MAX, -1);
+		if (ready == -1 && errno != EINTR) {
+			perror("epoll_wait() error\n");
+			break;
+		}
+		for (i = 0; i < ready; i++) {
+			if (events[i].data.fd == inputFd && fillLineReader(&reader) == -1 && errno != EINTR && errno != EAGAIN) {
+				reader.eof = 1;		//Input is unusable, treat it like the end of a script
+				interactive = 0;
 			}
-		}		
-	
-		/* Command Handler via switch statement */
-		exitFlag = commandHandler(arrayOfArgs, &count, lastFP, backgroundPs, &bCount);
-
-		/* Free arrayOfArgs */
-		freeArgs(arrayOfArgs, ARG_MAX);
-		count = 0;	
-	} while(exitFlag == 0);
-
-	/* Free backgroundPs to avoid memory leaks */
-	for (i = 0; i < bCount; i++) {
-		free(backgroundPs[i]);
-		backgroundPs[i] = NULL;
+			/* The signalfd is handled by backgroundChecker on the next pass */
+		}
 	}
 
+	close(epollFd);
+
+	/* Free background processes to avoid memory leaks */
+	freePool();
+	freeJobTable(&jobs);
+	freeArena(&lineArena);
+	freeLineReader(&reader);	//Free the block buffer inputBuffer points into
+	freeTrace();			//Write out the buffered events
+	freeHistory();
+	inputBuffer = NULL;
+	fflush(stdout);		//Batch mode output is only flushed here and before launching commands
+
 	free(lastFP);	//Free lastFP
 	lastFP = NULL;
 	return 0;
 }
 
-
-/*				          backgroundSwitch
- * Description: This function enables/disables background functionality of the smallsh script by updating the global flag "background_switch".
- * Parameters: int signo
- * Returns: void
- * Preconditions: N/A 
- */
-void backgroundSwitch(int signo) {
-    
-    /* If switch is in on position turn it to off position and display message */
-    if (background_switch == 1) {
-        background_switch = 0;    //Turn off background functionality
-        write(STDOUT_FILENO, "Entering foreground-only mode (& is now ignored)\n", 49);
-        fflush(stdout);     //Flush buffer to screen
-    }
-    
-    else if (background_switch == 0) {      //If in off position turn switch on and display message
-        background_switch = 1;    //Turn on background functionality
-        write(STDOUT_FILENO, "Exiting foreground-only mode\n", 29);
-        fflush(stdout);
-        
-    }
-   
-}
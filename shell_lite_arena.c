@@ -0,0 +1,142 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_arena.c
+* Description: This is the function implementation file for the per-line arena of the shellLite shell. A line that does not
+*              fit in the main block spills into overflow blocks, and the next reset replaces the main block with one large
+*              enough for that line, so the arena settles on one block sized for the longest line seen.
+* Citations:
+*         1. Hanson, David "Fast Allocation and Deallocation of Memory Based on Object Lifetimes", Assisted with the arena design.
+*/
+#include "shell_lite_arena.h"
+
+static long mallocCount = 0;    //Mallocs made by all arenas
+
+/*            initArena
+ * Description: This function allocates the main block of a.
+ * Parameters: struct arena* a, size_t size
+ * Returns: void
+ * Preconditions: a != NULL, size > 0
+ */
+void initArena(struct arena* a, size_t size) {
+    assert(a != NULL && size > 0);
+
+    a->base = malloc(size);
+    assert(a->base != NULL);
+    mallocCount++;
+    a->size = size;
+    a->used = 0;
+    a->overflow = NULL;
+    a->overflowBytes = 0;
+}
+
+/*            arenaAlloc
+ * Description: This function returns size bytes from a, aligned to ARENA_ALIGN. The memory is not initialized and stays valid until the next
+ *         arenaReset.
+ * Parameters: struct arena* a, size_t size
+ * Returns: pointer to the allocation
+ * Preconditions: a != NULL
+ */
+void* arenaAlloc(struct arena* a, size_t size) {
+    assert(a != NULL);
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (a->used + size <= a->size) {
+        void* p = a->base + a->used;
+        a->used += size;
+        return p;
+    }
+
+    /* Main block is full, carve from the newest overflow block or spill into a new one until the next reset */
+    struct arenaBlock* block = a->overflow;
+    if (block == NULL || block->used + size > block->size) {
+        size_t blockSize = size > a->size ? size : a->size;
+        block = malloc(ARENA_HEADER + blockSize);
+        assert(block != NULL);
+        mallocCount++;
+        block->next = a->overflow;
+        block->size = blockSize;
+        block->used = 0;
+        a->overflow = block;
+        a->overflowBytes += blockSize;
+    }
+
+    void* p = (char*)block + ARENA_HEADER + block->used;
+    block->used += size;
+    return p;
+}
+
+/*            arenaGrow
+ * Description: This function resizes the allocation old from oldSize to newSize bytes. When old is the newest allocation in the main block and the block
+ *         has room it grows in place, otherwise a new allocation is made and the contents copied. Doubling newSize keeps appends amortized O(1).
+ * Parameters: struct arena* a, void* old, size_t oldSize, size_t newSize
+ * Returns: pointer to the resized allocation
+ * Preconditions: a != NULL, newSize >= oldSize
+ */
+void* arenaGrow(struct arena* a, void* old, size_t oldSize, size_t newSize) {
+    assert(a != NULL && newSize >= oldSize);
+
+    size_t alignedOld = (oldSize + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    size_t alignedNew = (newSize + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (old != NULL && (char*)old + alignedOld == a->base + a->used && a->used - alignedOld + alignedNew <= a->size) {
+        a->used = a->used - alignedOld + alignedNew;    //Newest allocation, extend it in place
+        return old;
+    }
+
+    void* p = arenaAlloc(a, newSize);
+    if (old != NULL) { memcpy(p, old, oldSize); }
+    return p;
+}
+
+/*            arenaReset
+ * Description: This function releases every allocation of a. If the last line needed overflow blocks they are freed and base is replaced
+ *         with a block large enough to hold that line on its own.
+ * Parameters: struct arena* a
+ * Returns: void
+ * Preconditions: a != NULL
+ */
+void arenaReset(struct arena* a) {
+    assert(a != NULL);
+
+    if (a->overflow != NULL) {
+        size_t newSize = a->size + a->overflowBytes;
+        while (a->overflow != NULL) {
+            struct arenaBlock* next = a->overflow->next;
+            free(a->overflow);
+            a->overflow = next;
+        }
+        free(a->base);
+        a->base = malloc(newSize);
+        assert(a->base != NULL);
+        mallocCount++;
+        a->size = newSize;
+        a->overflowBytes = 0;
+    }
+    a->used = 0;
+}
+
+/*            freeArena
+ * Description: This function frees every block of a.
+ * Parameters: struct arena* a
+ * Returns: void
+ * Preconditions: a != NULL
+ */
+void freeArena(struct arena* a) {
+    assert(a != NULL);
+
+    arenaReset(a);
+    free(a->base);
+    a->base = NULL;
+    a->size = 0;
+}
+
+/*            arenaAllocations
+ * Description: Returns the number of mallocs made by all arenas, a steady stream of lines should not move it.
+ * Parameters: void
+ * Returns: long
+ * Preconditions: N/A
+ */
+long arenaAllocations(void) {
+    return mallocCount;
+}
@@ -0,0 +1,51 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_arena.h
+* Description: This is the function declaration file for the per-line arena of the shellLite shell. Everything built while
+*              parsing one command line (the expanded text and the argument array) is bump allocated from one block and
+*              released together by arenaReset. The block is reused for every line, so a steady stream of lines parses
+*              without calling malloc or free. arenaAllocations counts the mallocs the arenas have made.
+* Citations:
+*         1. Hanson, David "Fast Allocation and Deallocation of Memory Based on Object Lifetimes", Assisted with the arena design.
+*/
+#ifndef shell_lite_arena_h
+#define shell_lite_arena_h
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define ARENA_START_SIZE 16384    //Initial size of an arena block
+#define ARENA_ALIGN 16            //Every allocation is aligned to this many bytes
+#define ARENA_HEADER ((sizeof(struct arenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))    //Offset of the data in an overflow block
+
+                            /* Struct for extra blocks used when a line outgrows the arena */
+struct arenaBlock {
+    struct arenaBlock* next;    //Next overflow block
+    size_t size;                //Usable bytes after the header
+    size_t used;                //Bytes handed out from this block
+};
+
+                            /* Struct for a bump-pointer arena */
+struct arena {
+    char* base;                     //Main block
+    size_t size;                    //Size of base
+    size_t used;                    //Bytes handed out from base
+    struct arenaBlock* overflow;    //Blocks allocated since the last reset because base was full
+    size_t overflowBytes;           //Bytes held by overflow blocks
+};
+
+void initArena(struct arena*, size_t);    //Allocates the main block
+
+void* arenaAlloc(struct arena*, size_t);    //Returns size bytes that live until the next reset
+
+void* arenaGrow(struct arena*, void*, size_t, size_t);    //Resizes an allocation, in place when it is the newest one
+
+void arenaReset(struct arena*);    //Releases every allocation at once, grows base if the last line overflowed
+
+void freeArena(struct arena*);    //Frees every block
+
+long arenaAllocations(void);    //Number of mallocs made by all arenas
+
+#endif /* shell_lite_arena_h */
@@ -1,6 +1,6 @@
 /* Author: David Eaton
 * Date: 05/07/2020
-* Last Revised: 05/19/2020
+* Last Revised: 10/18/2026
 * File Name: shell_lite_builtins.c
 * Description: This is the function implementation file for the built in functions utilized in the shellLite shell.               This includes functions that assist the shell with function executions.
 * Citations:
@@ -13,6 +13,20 @@
           5. Brewster, Benjamin "More UNIX I/O" Assisted with I/O redirection
 */
 #include "shell_lite_builtins.h"
+#include "shell_lite_pipeline.h"
+#include "shell_lite_launch.h"
+#include "shell_lite_fastpath.h"
+#include "shell_lite_hash.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_parallel.h"
+#include "shell_lite_list.h"
+#include "shell_lite_subst.h"
+#include "shell_lite_glob.h"
+#include "shell_lite_cache.h"
+#include "shell_lite_history.h"
+#include "shell_lite_fanout.h"
+#include "shell_lite_stats.h"
+#include "shell_lite_pool.h"
 
 /* Function to initialize process */
 void initProcess(struct process* p) {
@@ -20,68 +34,178 @@ void initProcess(struct process* p) {
     p->pid = 0;
     p->exitValue = -1;
     p->signalValue = -1;
+    p->done = 0;
+    p->background = 0;
+    p->slot = -1;
+    p->next = NULL;
+    p->timed = 0;
+    p->jobId = 0;
+    p->pgid = 0;
+    p->stopped = 0;
+    memset(&p->start, 0, sizeof(p->start));
+    memset(&p->end, 0, sizeof(p->end));
+    memset(&p->usage, 0, sizeof(p->usage));
 }
 
 /*            parseBuffer
- * Description: This function parses the buffer argument by space and returns an array of strings where each element is a command/argument. Upon successful completion
- *         the function updates the count argument by reference with the number of initialized elements.
- * Parameters: char buffer[], int* count, int maxChars, int maxSize, int flag (flag for background functionality)
+ * Description: This function is the lexer of the shell. It reads the raw command line once, expanding $$ to pid and splitting it into words on
+ *         spaces, tabs and newlines. The special symbols <, <<, <<<, >, >+, |, &, ;, && and || end the current word and become arguments of their
+ *         own, so they do not need surrounding spaces. The text of every argument and the NULL terminated argument array are allocated from the line arena, the text
+ *         doubles as it fills and the array is sized once the words are counted, so lines have no fixed limit. A line whose arguments do not fit
+ *         in sysconf(_SC_ARG_MAX) bytes could never be exec'd and is rejected. Upon successful completion the function updates the count argument
+ *         by reference with the number of initialized elements, 0 for a rejected line. With a job table $(command) is kept in its word as written,
+ *         with SUBST_MARK for the $, and expandSubstitutions runs it when the word's command runs, so a list runs it only if it gets that far.
+ *         A SUBST_MARK byte in the input itself is dropped. Without a job table $( is plain text. Words holding *, ? or [ are then expanded to the sorted paths they match by expandGlobs, the ARG_MAX check
+ *         counts the expanded arguments.
+ * Parameters: char buffer[], size_t length, char* pid, int* count, int flag (flag for background functionality), struct arena* lineArena,
+ *         struct jobTable* jobs (NULL disables $(...))
  * Returns: char** updates count by reference.
- * Preconditions: maxChar > 0 maxSize > 0
+ * Preconditions: buffer != NULL, pid != NULL, lineArena != NULL
  */
-char** parseBuffer(char* buffer, int* count, int maxChars, int maxSize, int flag) {
-    assert(maxChars > 0 && maxSize > 0);        //Assert preconditions have been met.
-
-    int i;                //index to iterate through loops
-    char* word;            //Stores parsed string from strtok call
-    char test[maxChars];        //Used to test input against a blank command
-    memset(test, '\0', maxChars);
- 
-    /* Set up array of strings to hold parsed commands/arguments */
-    char** arrayOfArgs = malloc(maxSize * sizeof(char*));        //Dynamically create memory to hold maxSize strings
-    assert(arrayOfArgs != NULL);            //Assert the dynamic allocation was successful
-    for (i = 0; i < maxSize; i++) {
-        arrayOfArgs[i] = NULL;            //Initialize all to NULL
+char** parseBuffer(char* buffer, size_t length, char* pid, int* count, int flag, struct arena* lineArena, struct jobTable* jobs) {
+    assert(buffer != NULL && pid != NULL && lineArena != NULL);        //Assert preconditions have been met.
+
+    size_t i;                        //index into buffer
+    size_t pidLength = strlen(pid);
+    size_t capacity = length + pidLength + 2;    //Room for the words, grown when $$ expansions push past it
+    size_t used = 0;                 //Bytes written to text
+    int words = 0;                   //Number of words written to text
+    int inWord = 0;                  //1 while characters are being added to a word
+    int globbing = 0;                //1 if a word may be a pattern, lines without one skip expandGlobs
+    char* text = arenaAlloc(lineArena, capacity);    //Words separated by null terminators
+    char c;
+
+    for (i = 0; i < length && buffer[i] != '\0'; i++) {
+        c = buffer[i];
+
+        /* Every character adds at most pidLength + 2 bytes (a $$ expansion, or a symbol of up to three characters and its terminator) */
+        if (used + pidLength + 4 > capacity) {
+            text = arenaGrow(lineArena, text, used, capacity * 2);
+            capacity *= 2;
+        }
+
+        if (c == ' ' || c == '\t' || c == '\n') {
+            if (inWord) { text[used++] = '\0'; inWord = 0; }    //End of word
+        } else if (c == '<' || c == '>' || c == '|' || c == '&' || c == ';') {
+            if (inWord) { text[used++] = '\0'; inWord = 0; }
+            text[used++] = c;    //Special symbols are always a word of their own
+            if ((c == '&' || c == '|') && i + 1 < length && buffer[i + 1] == c) {
+                text[used++] = c;    //&& and || list operators
+                i++;
+            } else if (c == '>' && i + 1 < length && buffer[i + 1] == '+') {
+                text[used++] = '+';    //>+ fan-out redirection
+                i++;
+            } else if (c == '<' && i + 1 < length && buffer[i + 1] == '<') {
+                text[used++] = '<';    //<< here-document
+                i++;
+                if (i + 1 < length && buffer[i + 1] == '<') {
+                    text[used++] = '<';    //<<< here-string
+                    i++;
+                }
+            }
+            text[used++] = '\0';
+            words++;
+        } else if (c == SUBST_MARK) {
+            continue;    //Would read as a kept $( later, a literal one in the input is dropped
+        } else {
+            if (c == '$' && jobs != NULL && i + 1 < length && buffer[i + 1] == '(') {
+                /* Find the matching ), the command may hold parentheses and substitutions of its own */
+                size_t closing = i + 2;
+                int depth = 1;
+                for (; closing < length && buffer[closing] != '\0'; closing++) {
+                    if (buffer[closing] == '(') { depth++; }
+                    if (buffer[closing] == ')' && --depth == 0) { break; }
+                }
+                if (depth != 0) {
+                    fprintf(stderr, "Error, missing ) in command substitution\n");
+                    *count = 0;
+                    return NULL;
+                }
+
+                /* Keep the substitution in the word as written, expandSubstitutions runs it when the word's command runs */
+                if (used + (closing - i + 1) + pidLength + 4 > capacity) {
+                    text = arenaGrow(lineArena, text, used, used + (closing - i + 1) + capacity);
+                    capacity = used + (closing - i + 1) + capacity;
+                }
+                if (!inWord) { inWord = 1; words++; }
+                text[used++] = SUBST_MARK;
+                memcpy(text + used, buffer + i + 1, closing - i);
+                used += closing - i;
+                i = closing;
+                continue;
+            }
+            if (!inWord) { inWord = 1; words++; }    //Start of word
+            if (c == '$' && i + 1 < length && buffer[i + 1] == '$') {
+                memcpy(text + used, pid, pidLength);    //Expand $$ to the shell's pid
+                used += pidLength;
+                i++;
+            } else {
+                if (c == '*' || c == '?' || c == '[') { globbing = 1; }
+                text[used++] = c;
+            }
+        }
     }
+    if (inWord) { text[used++] = '\0'; }
+
+    /* Set up array of strings pointing at the words, one extra slot for the NULL terminator */
+    char** arrayOfArgs = arenaAlloc(lineArena, (words + 1) * sizeof(char*));
+    char* word = text;
+    int j;
+    for (j = 0; j < words; j++) {
+        arrayOfArgs[j] = word;
+        word += strlen(word) + 1;
+    }
+    arrayOfArgs[words] = NULL;
 
-    /* Parse buffer argument */
-    i = 0;
-    word = strtok(buffer, " ");
-    while (word != NULL) {
-        word[strcspn(word, "\n")] = '\0';    //Remove newline character getline adds
-        
-        /* Dynamically create space in arrayOfArgs to hold parsed word from buffer */
-        /*
-        arrayOfArgs[i] = (char*)malloc(sizeof(char*) * strlen(word));
-        assert(arrayOfArgs[i] != NULL);
-        memset(arrayOfArgs[i], '\0', sizeof(arrayOfArgs[i]));
-         */
-        arrayOfArgs[i] = (char*)malloc((strlen(word)+ 1));
-        assert(arrayOfArgs[i] != NULL);
-        memset(arrayOfArgs[i], '\0', (strlen(word)+ 1));
- 
-        strcpy(arrayOfArgs[i], word);    //Assign parsed word to arrayOfArgs
-        i++;             //increment index
-        word = strtok(NULL, " ");    //Get next word
+    if (globbing) {
+        arrayOfArgs = expandGlobs(arrayOfArgs, &words, &used, lineArena);    //Patterns become the paths they match
     }
 
-    if (strcmp(arrayOfArgs[0], test) == 0) { i = 0; }    //Empty command recieved
-     
-    *count = i;                    //Update count to be the number of initialized elements in arrayOfArgs
+    if (!argumentsFit(used, words)) {
+        *count = 0;
+        return NULL;
+    }
+    *count = words;
 
     /* Check flag to see if background functionality is enabled */
-    if (flag == 0) {
-        if (strcmp(arrayOfArgs[*count - 1], "&") == 0) {
-            /* if disabled remove background operator if there is one and update count */
-            free(arrayOfArgs[*count - 1]); arrayOfArgs[*count - 1] = NULL; //Free memory make pointer safe
-            *count = (*count) - 1;  //Decrement count
+    if (flag == 0 && *count > 0) {
+        /* if disabled remove the background operator ending the line or a command of a list, & between two commands becomes ;. Update count */
+        int kept = 0;
+        for (j = 0; j < words; j++) {
+            if (strcmp(arrayOfArgs[j], "&") == 0) {
+                if (j + 1 == words || findListOperator(arrayOfArgs + j + 1, words - j - 1) == 0) { continue; }
+                arrayOfArgs[j] = ";";
+            }
+            arrayOfArgs[kept++] = arrayOfArgs[j];
         }
-        
+        arrayOfArgs[kept] = NULL;    //Make pointer safe
+        *count = kept;
     }
-    
+
     return arrayOfArgs;                //Returned parsed arguments
 }
 
+/*            argumentsFit
+ * Description: This function checks arguments against sysconf(_SC_ARG_MAX), the kernel counts the argument strings and the pointers to them.
+ *         Arguments that do not fit could never be exec'd, an error is printed for them.
+ * Parameters: size_t bytes (length of the strings with their terminators), int words
+ * Returns: 1 if they fit, 0 if not
+ * Preconditions: words >= 0
+ */
+int argumentsFit(size_t bytes, int words) {
+    static long argLimit = 0;        //sysconf(_SC_ARG_MAX), read once
+
+    if (argLimit == 0) {
+        argLimit = sysconf(_SC_ARG_MAX);
+        if (argLimit <= 0) { argLimit = _POSIX_ARG_MAX; }
+    }
+    if (bytes + (words + 1) * sizeof(char*) > (size_t)argLimit) {
+        fprintf(stderr, "Error, arguments exceed the system limit of %ld bytes\n", argLimit);
+        return 0;
+    }
+    return 1;
+}
+
 /*            linearSearch
  * Description: This function performs a linear search of the char** array. Returns the index if found or -1 if not.
  * Parameters: char** args, char* word, int count
@@ -100,52 +224,100 @@ int linearSearch(char** args, char* word, int count) {
     return -1;
 }
                       
-/*            freeArgs
- * Description: This function frees all allocated memory associated with arrayOfArgs.
- * Parameters: char** array, int size
- * Returns: NA
- * Preconditions: char** array != NULL, int size > 0
- */
-void freeArgs(char** array, int size) {
-    assert(array != NULL && size > 0);
-
-    int i;
-    for ( i = 0; i < size; i++) {
-        free(array[i]);        //Free element in array of strings
-        array[i] = NULL;    //Make pointer safe
-    }
-
-    free(array);    //Free memory of the array itself
-    array = NULL;
-}
-
-/*            commandHandler
- * Description: This function routes commands to their appropriate if/else blocks and executes("handles them"). This function assists with overall readabilty of main.
- * Parameter: char** args, int* aCount(count of args), struct process* lastForeground, struct process* backgroundPs[], int* bCount(count of backgroundPs)
+/*            routeCommand
+ * Description: Routes one command, its $(...) already expanded, to the builtin or launcher that runs it.
+ * Parameter: char** args, int* aCount(count of args), struct process* lastForeground, struct jobTable* jobs
  * Returns: 1 if command exit executes else returns 0
- * Preconditions: args != NULL, aCount > 0, bCount >= 0
+ * Preconditions: args != NULL, aCount > 0, jobs != NULL, args holds no list operator
  */
-int commandHandler(char** args, int* aCount, struct process* lastForeground, struct process* backgroundPs[], int* bCount) {
-    assert(args != NULL && aCount > 0);
-    assert(*bCount >= 0);
-
+static int routeCommand(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
     /* Utilize the first element in args(the command) to route command to proper execution point */
     if (strcmp(args[0], "cd") == 0) {
         cd(args[1], *aCount);    //Change directories
 
     } else if (strcmp(args[0], "exit") == 0) {
-        exitShell(backgroundPs, *bCount);    //Kill background running processes
+        exitShell(jobs);    //Kill background running processes
         return 1;    //Signal smallsh to terminate
 
     } else if (strcmp(args[0], "status") == 0) {
         status(lastForeground);    //Get status of most recent foreground process
 
+    } else if (strcmp(args[0], "hash") == 0) {
+        hashCommand(args, *aCount);    //List or clear the command path cache
+
+    } else if (strcmp(args[0], "stats") == 0) {
+        statsCommand(args, *aCount);    //Print or reset the shell's own latency histograms
+
+    } else if (strcmp(args[0], "jobs") == 0) {
+        jobsCommand(jobs);    //List background jobs
+
+    } else if (strcmp(args[0], "fg") == 0) {
+        fgCommand(args, *aCount, lastForeground, jobs);    //Continue a job in the foreground
+
+    } else if (strcmp(args[0], "bg") == 0) {
+        bgCommand(args, *aCount, jobs);    //Continue a stopped job in the background
+
+    } else if (strcmp(args[0], "wait") == 0) {
+        waitCommand(args, *aCount, jobs);    //Wait for background jobs
+
+    } else if (strcmp(args[0], "kill") == 0 && findJobArgument(args, *aCount)) {
+        killCommand(args, *aCount, jobs);    //Signal a %n job, other kill lines run the kill program
+
+    } else if (strcmp(args[0], "history") == 0) {
+        historyCommand(args, *aCount);    //List or search the command history
+
+    } else if (strcmp(args[0], "cache") == 0) {
+        cacheCommand(args, aCount, lastForeground, jobs);    //Replay or record the output of a deterministic command
+
+    } else if (strcmp(args[0], "time") == 0 && *aCount > 1) {
+        timeCommand(args, aCount, lastForeground, jobs);    //Run the rest of the line and report its resource usage
+
+    } else if (strcmp(args[0], "parallel") == 0) {
+        parallelCommand(args, *aCount, lastForeground, jobs);    //Run a list of commands N at a time
+
+    } else if (linearSearch(args, "|", *aCount) > -1) {
+        pipelineLauncher(args, aCount, lastForeground, jobs);    //Launch commands joined by |
+
     } else {
-        commandLauncher(args, aCount, lastForeground, backgroundPs, bCount);     //Launch non-builtin commands
+        commandLauncher(args, aCount, lastForeground, jobs);     //Launch non-builtin commands
     }
     return 0;
 }
 
+/*            commandHandler
+ * Description: This function routes commands to their appropriate if/else blocks and executes("handles them"). This function assists with overall readabilty of main.
+ *         A list is split first, so the $(...) of each command runs only when that command does. Its output is kept in an arena of its own
+ *         until the command is done.
+ * Parameter: char** args, int* aCount(count of args), struct process* lastForeground, struct jobTable* jobs
+ * Returns: 1 if command exit executes else returns 0
+ * Preconditions: args != NULL, aCount > 0, jobs != NULL
+ */
+int commandHandler(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && aCount > 0);
+    assert(jobs != NULL);
+
+    struct arena substArena;    //Words the command's $(...) expanded to
+    char pid[24];
+    int exiting = 0;
+
+    /* A list runs each of its commands through here again */
+    if (findListOperator(args, *aCount) > -1) {
+        return listLauncher(args, aCount, lastForeground, jobs);    //Commands joined by ;, && or ||
+    }
+
+    if (!hasSubstitution(args, *aCount)) {
+        return routeCommand(args, aCount, lastForeground, jobs);
+    }
+    sprintf(pid, "%d", (int)getpid());
+    initArena(&substArena, ARENA_START_SIZE);
+    args = expandSubstitutions(args, aCount, pid, jobs, &substArena);
+    if (*aCount > 0) {
+        exiting = routeCommand(args, aCount, lastForeground, jobs);
+    }
+    freeArena(&substArena);
+    return exiting;
+}
+
 
 /*            cd
  * Description: This function changes the working directory of the smallsh shell. With no arguments it changes to the HOME directory and with 1 argument it changes
@@ -160,37 +332,26 @@ void cd(char path[], int argCount) {
     if (argCount == 1) {        //cd with 0 arguments
         if (chdir(getenv("HOME"))) {
             printf("Problem navigating to home environment variable directory\n");    //If there is a problem navigating to the home directory display error
-            fflush(stdout);
         }
     } else if (argCount == 2) {    //cd with 1 argument
             if (chdir(path)) {
             printf("Problem couldn't change to %s\n", path);    //If there is a problem changing to absolute path
-                fflush(stdout);
             }
     }
+    resetPool();    //Idle helpers still have the old working directory
 }
 
 /*            exitShell
  * Description: This function exits the smallsh shell. It causes the smallsh to kill any processes or jobs that the smallsh shell has started before it terminates
  *         itself.
- * Parameters: struct process* backgroundPs, int count
+ * Parameters: struct jobTable* jobs
  * Returns: void
  * Preconditiones: N/A
  */
-void exitShell(struct process* backgroundPs[], int count) {
-    pid_t completedPID = -1;    //Stores PID of completed process from backgroundPIDs
-    int i;
-    int exitMethod = -5;        //Stores exit method from waitPID
-
-    if (count > 0) {
-        /* Kill any running background process */
-        for (i = 0; i < count; i++) {
-            if (completedPID == 0) {
-                /* If running kill process */
-                kill(backgroundPs[i]->pid, SIGTERM);
-            }
-        }
-    }
+void exitShell(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    terminateJobs(jobs);    //Kill and reap every background job
 }
 
 /*            status
@@ -203,20 +364,17 @@ void status(struct process* last) {
     assert( last != NULL);
 
     /* No foreground process has occured */
-    if (last->pid <= 0) {
+    if (last->exitValue < 0 && last->signalValue < 0) {
         printf("exit value %d\n", 0);    //Display exit value to terminal
-        fflush(stdout);
     } else {
         /* EXIT case */
         if (last->exitValue >= 0) {
             printf("exit value %d\n", last->exitValue);    //Display exit value to terminal
-            fflush(stdout);
         }
          
         /* SIGNAL Case */
         if (last->signalValue >= 0) {
             printf("terminated by signal %d\n", last->signalValue);    //Display the signal to the terminal
-            fflush(stdout);
         }
 
     }
@@ -224,267 +382,215 @@ void status(struct process* last) {
 
 
 /*            commandLauncher
- * Description: This function launches nonbuilt-in commands by fork and exec. lastForegroundPID as well as bCount and backgroundPIDs are updated
- *         via reference.
- * Parameters: char** args, int* aCount, struct process* lastForeground, struct process* backgroundPs[], int* bCount
+ * Description: This function launches nonbuilt-in commands. Redirections and the background operator are resolved in the shell into a launchPlan,
+ *         then the command is started by the launch engine. With >+ targets a relay copies the command's stdout to them, it is waited for with a
+ *         foreground command and joins the job of a background one. lastForeground and the job table are updated via reference.
+ * Parameters: char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs
  * Returned: void
- * Preconditions: args != NULL, aCount >=1, lastForeground != NULL, backgroundPs != NULL, bCount != NULL
+ * Preconditions: args != NULL, aCount >=1, lastForeground != NULL, jobs != NULL
  */
-void commandLauncher(char** args, int* aCount, struct process* lastForeground, struct process* backgroundPs[], int* bCount) {
+void commandLauncher(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
     assert(args != NULL && *aCount >= 1);
-    assert(lastForeground != NULL && backgroundPs != NULL && bCount != NULL);
-
-    int i, j;        //index
-    pid_t spawnPID = -5;        //Stores PID from fork()
-    int childExitStatus = -5;    //Stores exitStatus of child process
-    int fd = -5;            //file descriptor
-
-    /* Create a child process to carry out command execution */
-    spawnPID = fork();
-    switch (spawnPID) {
-        case -1: {perror("Error with fork in commandLauncher\n"); exit(1); break;}    //Error case
-
-        case 0: {
-                /* Check for redirection */
-                int stdinRedirectionOperator = linearSearch(args, "<", *aCount);    //index of ">" in args
-
-                if ( stdinRedirectionOperator > -1) {
-                    fd = open(args[stdinRedirectionOperator + 1], O_RDONLY);  //Open file for reading only
-                    if (fd == -1 ) { perror("open() error\n"); exit(1); }     //Print error if issue and set exit value to 1
-                        
-                    if ((dup2(fd, 0)) == -1) {     //Redirect standard input to target given.
-                        perror("dup2 stdin redirection fail!\n");        //Print error if unsuccessful
-                        exit(1);
-                    }
-
-                    /* Get rid of background operator for execvp function */
-                    free(args[stdinRedirectionOperator]);  args[stdinRedirectionOperator] = NULL;
-                    shiftLeft(args, stdinRedirectionOperator, *aCount);    //Close gap in args
-                    *aCount = (*aCount - 1);    //Decrement args count by reference
-
-                    /* Get rid of file path from args */
-                    free(args[stdinRedirectionOperator]); args[stdinRedirectionOperator] = NULL;    //Note previous shift
-                    shiftLeft(args, stdinRedirectionOperator, *aCount);
-                    *aCount = (*aCount - 1);
-    
-                }
+    assert(lastForeground != NULL && jobs != NULL);
 
-                int stdoutRedirectionOperator = linearSearch(args, ">", *aCount);       //index of "<" in args
-                if (stdoutRedirectionOperator > -1) {
-                    fd = open(args[stdoutRedirectionOperator + 1], O_WRONLY | O_CREAT | O_TRUNC, 0644);  //Open file for writing only, create or Trunc
-                    if (fd == -1 ) { perror("open() error\n"); exit(1); }     //Print error if issue and set exit value to 1
-                        
-                    if ((dup2(fd, 1)) == -1) {     //Redirect standard output to target  given.
-                        perror("dup2 stdout redirection fail!\n");        //Print error if unsuccessful
-                        exit(1);
-                    }
-
-                    /* Get rid of background operator for execvp function */
-                    free(args[stdoutRedirectionOperator]);  args[stdoutRedirectionOperator] = NULL;
-                    shiftLeft(args, stdoutRedirectionOperator, *aCount);
-                    *aCount = (*aCount - 1);
- 
-                    /* Get rid of file path from args */
-                    free(args[stdoutRedirectionOperator]);  args[stdoutRedirectionOperator] = NULL;
-                                        shiftLeft(args, stdoutRedirectionOperator, *aCount);
-                                        *aCount = (*aCount - 1);
+    pid_t spawnPID = -5;        //Stores PID from the launch engine
+    struct launchPlan plan;      //Redirections and background flag resolved in the shell
+    struct process relay;        //Copies stdout to the >+ targets, pid 0 if there are none
 
-                }
-                
-                /* Background with no redirection targets given */
-                if (strcmp(args[*aCount - 1], "&") == 0 && stdoutRedirectionOperator == -1 && stdinRedirectionOperator == -1) {
-                    /* Output redirection */
-                    fd = open("/dev/null", O_WRONLY | O_CREAT | O_TRUNC, 0644);    //Open file for writing only, create one or truncate
-                    if (fd == -1 ) { perror("open() error\n"); exit(1); }     //Print error if issue and set exit value to 1
-                        
-                    if ((dup2(fd, 1)) == -1) {     //Redirect background standard output to /dev/null if no target is given.
-                        perror("dup2 background default stdout redirection fail!\n");        //Print error if unsuccessful
-                        exit(1);
-                    }
-
-                    /* Input redirection */
-                    fd = open("/dev/null", O_RDONLY);    //Open file for read only
-                    if (fd == -1 ) { perror("open() error\n"); exit(1); }        //Error handling for open()
-
-                    if ((dup2(fd, 0)) == -1) {    //Redirect background standard input to be from /dev/null if no target is given
-                        perror("dup2 background default stdin redirection fail!\n");
-                        exit(1);
-                    }
+    initProcess(&relay);
 
-                }
+    if (buildLaunchPlan(args, *aCount, &plan) == -1) { return; }
 
-                /* Get rid of background operator for exexvp function */
-                if (strcmp(args[*aCount - 1], "&") == 0) {
-                    free(args[*aCount - 1]);  args[*aCount - 1] = NULL;
-                    *aCount = (*aCount - 1);    //Decrement args count by reference
-                    
-                }
-                else {
-                    /* Set up child foreground process to respond to SIGINT */
-                    struct sigaction SIGINT_action = {0};
-                    SIGINT_action.sa_handler = SIG_DFL;     //Set foreground processes to respons normally to SIGINT
-                    sigaction(SIGINT, &SIGINT_action, NULL);
-                }
-            
-                /* Execute Command */
-                if (execvp(*args, args) < 0) {
-                    perror("Exec failure!\n");        //If there is a problem with executing command print error and set exit status to  1
-                    exit(1);
-                }
-                break;
-            }
+    /* echo, test and friends run inside the shell unless they need the real program */
+    if (fastPathCommand(&plan, lastForeground) == 0) {
+        closeLaunchPlan(&plan);
+        return;
+    }
 
-        default: {
-                /* Check to see if command should be executed in the background or the foreground */
-                if (strcmp(args[*aCount - 1], "&") == 0) {
-                    printf("Background pid is %d!\n", spawnPID);
-                    fflush(stdout);
-
-                    /* Add background process info to backgroundPs */
-                    backgroundPs[*bCount] = malloc(sizeof(struct process));    //Dynamically allocate memory for new process struct
-                    initProcess(backgroundPs[*bCount]);    //Initialize element
-                    backgroundPs[*bCount]->pid = spawnPID;    //Save pid
-                    *bCount = (*bCount + 1);    //Increment count of background processes
-                } else {
-                    initProcess(lastForeground);        //reset lastForeground;s variables for subsequent foreground processess.
-                    
-                    lastForeground->pid = waitpid(spawnPID, &childExitStatus,0);        //Ensure foreground process completes and save pid
-
-                    /* EXIT case */
-                    if (WIFEXITED(childExitStatus)) {
-                        lastForeground->exitValue = WEXITSTATUS(childExitStatus);    //Store exit status value
-                    }
-         
-                    /* SIGNAL Case */
-                    if (WIFSIGNALED(childExitStatus)) {
-                        lastForeground->signalValue = WTERMSIG(childExitStatus);    //Store Signal Value
-                        status(lastForeground);   //Print signal that terminated foreground process
-                    }
+    /* Open redirection targets, put the >+ relay in front of stdout */
+    int opened = openLaunchPlan(&plan) == 0;
+    if (opened && plan.teeCount > 0) {
+        relay.pid = startFanOut(&plan);
+        opened = relay.pid != -1;
+        if (opened && plan.background) {
+            addJob(jobs, relay.pid, relay.pid);    //The relay leads the job's process group, the command joins it
+        } else if (opened) {
+            trackProcess(jobs, &relay);
+        }
+    }
 
-                }
-                break;
-            }
+    /* Start the command, failures count as exit value 1 for foreground commands */
+    if (!opened || (spawnPID = launchCommand(&plan)) == -1) {
+        if (!plan.background) {
+            initProcess(lastForeground);
+            lastForeground->exitValue = 1;
+        }
+        closeLaunchPlan(&plan);
+        if (relay.pid > 0 && !plan.background) { waitForCommand(jobs, &relay); }    //Relay sees EOF and exits
+        return;
+    }
+    closeLaunchPlan(&plan);    //Child holds its own copies of the redirection descriptors
+
+    /* Check to see if command should be executed in the background or the foreground */
+    if (plan.background) {
+        printf("Background pid is %d!\n", spawnPID);
+
+        addJob(jobs, spawnPID, relay.pid > 0 ? relay.pid : spawnPID);    //Add background process to the job table, it leads its own process group
+    } else {
+        initProcess(lastForeground);        //reset lastForeground;s variables for subsequent foreground processess.
+        lastForeground->pid = spawnPID;
+        trackProcess(jobs, lastForeground);
+        waitForCommand(jobs, lastForeground);    //Ensure foreground process completes, exit or signal value is recorded by the reaper
+        if (relay.pid > 0) { waitForCommand(jobs, &relay); }    //Every copy is written before the prompt returns
+
+        /* SIGNAL Case */
+        if (lastForeground->signalValue >= 0) {
+            status(lastForeground);   //Print signal that terminated foreground process
+        }
     }
 }
 
 
-/*            backgroundChecker
- * Description: This function checks for completed background processes via waitpid. This function utilizes the NOHANG flag so that commands can still continue
- *         in the foreground. This process also cleans up background process as they finish and displays the process that has finished.
- * Parameters: struct process* arr, int* count
+/*            timeCommand
+ * Description: This function is the time prefix. The rest of the line is run through commandHandler, then the wall clock time is printed to stderr
+ *         together with the resource usage wait4 reported for the foreground command: user and system CPU, max RSS, page faults and context switches.
+ *         For a pipeline the usage of every stage is added up. A background command is timed when it finishes, with its completion message.
+ * Parameters: char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs
  * Returns: void
- * Preconditions: arr != NULL, *count >= 0
+ * Preconditions: args != NULL, *aCount >= 2, lastForeground != NULL, jobs != NULL
  */
-void backgroundChecker(struct process* arr[], int* count) {
-    assert(arr != NULL && *count >= 0);
-
-    int completedFlag = -1;
-    int exitStatus = -5;
-    int i, j;
- 
-    for ( i = 0; i < *count; i++) {
-        completedFlag = waitpid(arr[i]->pid, &exitStatus, WNOHANG);    //See if process is complete
-
-        if (completedFlag > 0) {
-            printf("background pid %d is done: ", completedFlag);    //Display message stating process is complete
-            fflush(stdout);
-
-            /* EXIT case */
-            if (WIFEXITED(exitStatus)) {
-                printf("exit value %d\n", WEXITSTATUS(exitStatus));    //Display exit status of process
-                fflush(stdout);
-            }
-         
-            /* SIGNAL Case */
-            if (WIFSIGNALED(exitStatus)) {
-                printf("terminated by signal %d\n", WTERMSIG(exitStatus));    //Display signal value
-                fflush(stdout);
-            }
+void timeCommand(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && *aCount >= 2);
+    assert(lastForeground != NULL && jobs != NULL);
 
-            /* Free memory and close gap in array */
-            free(arr[i]);
-            arr[i] = NULL;    //Make pointer safe
-            for ( j = i; j < *count; j++) {
-                arr[j] = arr[j + 1];    //Close gap in arr
-            }
-            *count = (*count - 1);    //Update count of arr
+    int count = *aCount - 1;    //Arguments without the time prefix
+    struct timespec start, end;
 
-        }
-        completedFlag = -1;    //reset flag
+    initProcess(lastForeground);    //done is only set again if a foreground command is reaped
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    jobs->timing = 1;
+    commandHandler(args + 1, &count, lastForeground, jobs);
+    jobs->timing = 0;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (strcmp(args[*aCount - 1], "&") == 0) { return; }    //Reported by backgroundChecker
+
+    fflush(stdout);    //Keep the report after the command's own output in batch mode
+
+    if (lastForeground->done) {
+        printUsage(stderr, lastForeground);
+    } else {
+        /* Builtin or nothing launched, only the wall clock time is known */
+        fprintf(stderr, "real %.3fs\n", (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
     }
 }
 
-/*            variableExpansion
- * Description: This function replaces all instances of $$ with the shell process id. This function returns a new dynamically allocated string.
- * Parameters: char* original, char pid[]
- * Returns: New string with $$ expanded to pid
- * Preconditions: No parameters can be NULL
+/*            printUsage
+ * Description: This function prints the wall clock time and the wait4 resource usage of a reaped process on one line.
+ * Parameters: FILE* out, struct process* p
+ * Returns: void
+ * Preconditions: out != NULL, p != NULL, p has been reaped
+ */
+void printUsage(FILE* out, struct process* p) {
+    assert(out != NULL && p != NULL);
+
+    double real = (p->end.tv_sec - p->start.tv_sec) + (p->end.tv_nsec - p->start.tv_nsec) / 1e9;
+    double user = p->usage.ru_utime.tv_sec + p->usage.ru_utime.tv_usec / 1e6;
+    double sys = p->usage.ru_stime.tv_sec + p->usage.ru_stime.tv_usec / 1e6;
+
+    fprintf(out, "real %.3fs user %.3fs sys %.3fs maxrss %ldKB faults %ld major %ld minor switches %ld voluntary %ld involuntary\n",
+            real, user, sys, p->usage.ru_maxrss, p->usage.ru_majflt, p->usage.ru_minflt, p->usage.ru_nvcsw, p->usage.ru_nivcsw);
+}
+
+
+/*            backgroundChecker
+ * Description: This function reaps finished children through the job table and displays every background process that has finished since the last
+ *         prompt. Jobs that finished while a foreground command ran were already reaped, only their messages are pending here. A SIGTSTP received
+ *         meanwhile is announced here as well, so the message never interrupts a foreground command's output.
+ * Parameters: struct jobTable* jobs
+ * Returns: number of messages displayed
+ * Preconditions: jobs != NULL
  */
-char* variableExpansion(char* original, char* pid) {
-    assert(original != NULL &&  pid != NULL);
-   // printf("pid: %s\n", pid);
+int backgroundChecker(struct jobTable* jobs) {
+    assert(jobs != NULL);
 
-    int varLength = 2;    //Length of $$
-    int pidLength = strlen(pid);    //Length of pid
+    int i;
+    int shown;
+    struct process* p;
 
+    reapChildren(jobs);
+    shown = jobs->finishedCount + jobs->modeChanged;
 
-    /* Get frequency of "$$" in orgianl for proper memory allocation of product */
-    int i;    //index
-    int freq = 0;
-    int subCount = 0;   //1 freq = two subCount
-    for (i = 0; i < strlen(original); i++) {
-        if (original[i] == '$') {
-            subCount++;     //Count character
+    if (jobs->modeChanged) {
+        if (jobs->foregroundOnly) {
+            printf("Entering foreground-only mode (& is now ignored)\n");
         } else {
-            subCount = 0;   //If not '$' reset subCount
+            printf("Exiting foreground-only mode\n");
         }
-        
-        if (subCount == 2) {
-             freq++;        //Count each occurance of "$$"
-            subCount = 0;   //Reset subCount
+        jobs->modeChanged = 0;
+    }
+
+    for (i = 0; i < jobs->finishedCount; i++) {
+        p = jobs->finished[i];
+        printf("background pid %d is done: ", p->pid);    //Display message stating process is complete
+
+        /* EXIT case */
+        if (p->exitValue >= 0) {
+            printf("exit value %d\n", p->exitValue);    //Display exit status of process
         }
+
+        /* SIGNAL Case */
+        if (p->signalValue >= 0) {
+            printf("terminated by signal %d\n", p->signalValue);    //Display signal value
+        }
+
+        if (p->timed) {
+            printUsage(stdout, p);    //Job was started with the time prefix
+        }
+
+        free(p);    //Free memory
+        jobs->finished[i] = NULL;    //Make pointer safe
     }
+    jobs->finishedCount = 0;
+    return shown;
+}
 
-    //Uncomment below to see freq for troubleshooting
-    //printf("frequency %d\n", freq);
-    int productSize = (strlen(original) + (freq * (pidLength - varLength))) + 1;
-    
-    char* product = malloc(productSize);    //stores new string with replacements made
-    assert(product != NULL);
-    memset(product, '\0', productSize);        //Initialize with null terminators for safety
+/*            variableExpansion
+ * Description: This function replaces all instances of $$ with the shell process id. This function returns a new string allocated from the line arena.
+ *         original is scanned once to size the product and once to fill it.
+ * Parameters: char* original, char pid[], struct arena* lineArena
+ * Returns: New string with $$ expanded to pid
+ * Preconditions: No parameters can be NULL
+ */
+char* variableExpansion(char* original, char* pid, struct arena* lineArena) {
+    assert(original != NULL &&  pid != NULL && lineArena != NULL);
+
+    size_t pidLength = strlen(pid);    //Length of pid
+    size_t length = 0;                 //Length of original
+    size_t freq = 0;                   //Occurances of "$$"
+    size_t i, j;                       //index
+
+    /* Get frequency of "$$" in orginal for proper memory allocation of product */
+    for (length = 0; original[length] != '\0'; length++) {
+        if (original[length] == '$' && original[length + 1] == '$') {
+            freq++;
+            length++;    //A pair is consumed together, "$$$" is one pair and a $
+        }
+    }
 
+    char* product = arenaAlloc(lineArena, length + freq * pidLength + 1);    //stores new string with replacements made
 
     /* Make replacements */
-    subCount = 0;
-    int j = 0;
-    for (i = 0; i < strlen(original); i++) {
-        if (original[i] == '$') {
-            if (subCount == 0 && i + 1 < strlen(original) && original[i+1] != '$') {
-                 product[j] = original[i];   //Copy over single $ characters
-                 j++;
-            }
-            subCount++;     //Count character
-        } else {
-            subCount = 0;   //If not '$' reset subCount
-            product[j] = original[i];   //Copy over non $ characters
-            j++;
-        }
-        
-        if (subCount == 2) {
-             freq--;        //Decrement freq for error checking after loop
-            
-            /* Copy pid into product */
-            strcat(product, pid);
+    for (i = 0, j = 0; i < length; i++) {
+        if (original[i] == '$' && original[i + 1] == '$') {
+            memcpy(product + j, pid, pidLength);    //Copy pid into product
             j += pidLength;
-            
-            subCount = 0;   //Reset subCount
+            i++;
+        } else {
+            product[j++] = original[i];    //Copy over other characters
         }
     }
-    assert(freq == 0);  //Check to make sure correct number of swaps were made
-    
-    //Uncomment to check the content of product 
-    //printf("%s", product); fflush(stdout);
-  
+    product[j] = '\0';
 
     return product;
 }
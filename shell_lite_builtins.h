@@ -1,6 +1,6 @@
 /* Author: David Eaton
 * Date: 05/07/2020
-* Last Revised: 05/19/2020
+* Last Revised: 10/18/2026
 * File Name: shell_lite_builtins.h
 * Description: This is the function declaration file for the built in functions utilized in the shellLite shell. This
 *              includes functions that assist the shell with function executions.
@@ -24,37 +24,60 @@
 #include <assert.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "shell_lite_arena.h"
+
+#define SUBST_MARK '\001'    //Stands for the $ of a $( kept in a word by the lexer, the command runs when the word's command does
 
                             /* Struct to make storing info about processes easier */
 struct process {
     pid_t pid;            //Stores process id
     int exitValue;        //Stores exit value
     int signalValue;        //Stores signal value
+    int done;            //1 once the process has been reaped
+    int background;        //1 for background jobs
+    int slot;            //Index in the job table's background list, -1 if not listed
+    int timed;            //1 if the resource usage is printed when the process finishes
+    int jobId;            //Job number used by %n, stages of a background pipeline share it
+    pid_t pgid;            //Process group of the job
+    int stopped;        //1 while the process is stopped by a signal
+    struct timespec start;    //Launch time, CLOCK_MONOTONIC
+    struct timespec end;    //Reap time, CLOCK_MONOTONIC
+    struct rusage usage;    //Resource usage reported by wait4
+    struct process* next;    //Next process in the same job table hash bucket
 };
 
+struct jobTable;    //Table of children the shell is waiting on, see shell_lite_jobs.h
+
 void initProcess(struct process* p);    //Function to initialize process
 
 
                                     /* Built in Functions */
-char** parseBuffer(char*, int*, int, int, int);    //Parses commands given by user and returns an array of string commands.
+char** parseBuffer(char*, size_t, char*, int*, int, struct arena*, struct jobTable*);    //Expands $$ and splits a command line into an array of string commands in one pass.
     
+int argumentsFit(size_t, int);    //Returns 1 if arguments of the given size could be exec'd, prints an error otherwise
+
 int linearSearch(char**, char*, int);        //Returns index of word from char** if found, or returns -1
     
-void freeArgs(char** , int);            //Frees the char** array holding parsed arguments, implemented for readability and to prevent memory leaks.
-    
-int commandHandler(char**, int*, struct process*, struct process* [], int*);    //Routes commands for execution
+int commandHandler(char**, int*, struct process*, struct jobTable*);    //Routes commands for execution
     
 void status(struct process*);            //Displays either the exit value or signal value of the most recent foreground process
     
-void exitShell(struct process* [], int count);    //Terminates active background processes
+void exitShell(struct jobTable*);    //Terminates active background processes
     
 void cd(char [], int);        //Changes working directory of shell
     
-void commandLauncher(char**, int*, struct process*, struct process* [], int*);    //Launches nonbuilt-in commands
+void commandLauncher(char**, int*, struct process*, struct jobTable*);    //Launches nonbuilt-in commands
     
-void backgroundChecker(struct process* [], int*);    //Checks and cleans up completed background processes
+void timeCommand(char**, int*, struct process*, struct jobTable*);    //Runs a command and prints its wall clock time and resource usage
+
+void printUsage(FILE*, struct process*);    //Prints the wall clock time and resource usage of a reaped process
+
+int backgroundChecker(struct jobTable*);    //Checks and cleans up completed background processes
     
-char* variableExpansion(char*, char *);        //This function replaces all instances of $$ with the pid of the shell
+char* variableExpansion(char*, char *, struct arena*);        //This function replaces all instances of $$ with the pid of the shell
     
 void shiftLeft(char**, int s, int c);            //Shifts array of strings to left by 1 element, starting at int s and ending at end c
 
@@ -0,0 +1,455 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_cache.c
+* Description: This is the function implementation file for the output cache of the shellLite shell. A miss runs the command
+*              through commandLauncher with stdout sent to a temporary file in the cache directory, then appends the full key and
+*              a trailer and renames the file to the key's hash. The stored output starts at offset 0, so a hit is one sendfile to
+*              the real destination. An entry's mtime is its last use and drives eviction.
+* Citations:
+*         1. Fowler, Noll, Vo "FNV hash", Assisted with the key hash.
+*         2. sendfile(2) and rename(2) Linux manual pages, Assisted with replaying and publishing entries.
+*/
+#include "shell_lite_cache.h"
+#include <dirent.h>
+#include <sys/sendfile.h>
+
+                            /* Struct stored at the end of every entry */
+struct cacheTrailer {
+    unsigned magic;                 //CACHE_MAGIC
+    int exitValue;                  //Exit value of the command
+    unsigned long long outLength;   //Bytes of stdout at the start of the entry
+    unsigned long long keyLength;   //Bytes of key right before the trailer
+};
+
+                            /* Struct for one entry while evicting */
+struct cacheFile {
+    char name[32];
+    off_t size;
+    struct timespec used;           //Last hit or store
+};
+
+static long cacheHits = 0;          //Commands replayed from the cache
+static long cacheMisses = 0;        //Commands run and stored
+static long cacheEvictions = 0;     //Entries removed to stay under the size limit
+static char* cacheDir = NULL;       //Cache directory, created on first use
+
+/*            cacheDirectory
+ * Description: Returns the cache directory from SHELLLITE_CACHE_DIR or $HOME/.shellLite_cache, creating it on first use.
+ * Parameters: void
+ * Returns: directory, NULL if it cannot be created
+ * Preconditions: N/A
+ */
+static char* cacheDirectory(void) {
+    char* setting;
+    char* home;
+
+    if (cacheDir != NULL) { return cacheDir; }
+    setting = getenv("SHELLLITE_CACHE_DIR");
+    if (setting != NULL && setting[0] != '\0') {
+        cacheDir = strdup(setting);
+    } else {
+        home = getenv("HOME");
+        if (home == NULL) { home = "."; }
+        cacheDir = malloc(strlen(home) + sizeof("/.shellLite_cache"));
+        if (cacheDir != NULL) { sprintf(cacheDir, "%s/.shellLite_cache", home); }
+    }
+    assert(cacheDir != NULL);
+
+    if (mkdir(cacheDir, 0700) == -1 && errno != EEXIST) {
+        perror("cache mkdir() error\n");
+        free(cacheDir);
+        cacheDir = NULL;
+    }
+    return cacheDir;
+}
+
+/*            appendKey
+ * Description: Appends length bytes of text and a null terminator to the growing key.
+ * Parameters: char** key, size_t* used, size_t* capacity, char* text, size_t length
+ * Returns: void
+ * Preconditions: *key was malloc'd with *capacity bytes
+ */
+static void appendKey(char** key, size_t* used, size_t* capacity, char* text, size_t length) {
+    while (*used + length + 1 > *capacity) {
+        *capacity *= 2;
+        *key = realloc(*key, *capacity);
+        assert(*key != NULL);
+    }
+    memcpy(*key + *used, text, length);
+    *used += length;
+    (*key)[(*used)++] = '\0';
+}
+
+/*            appendIdentity
+ * Description: Appends the identity of file to the key if it exists, the marker tells the input from the arguments.
+ * Parameters: char** key, size_t* used, size_t* capacity, char* marker, char* file
+ * Returns: void
+ * Preconditions: marker != NULL, file != NULL
+ */
+static void appendIdentity(char** key, size_t* used, size_t* capacity, char* marker, char* file) {
+    struct stat info;
+    char text[160];
+    int length;
+
+    if (stat(file, &info) == -1) { return; }
+    length = snprintf(text, sizeof(text), "%s %llx %llx %lld %lld.%09ld", marker, (unsigned long long)info.st_dev,
+                      (unsigned long long)info.st_ino, (long long)info.st_size, (long long)info.st_mtim.tv_sec, info.st_mtim.tv_nsec);
+    appendKey(key, used, capacity, text, length);
+}
+
+/*            buildKey
+ * Description: Builds the key of plan: working directory, argv, then the identity of the < input and of each argument naming a file.
+ * Parameters: struct launchPlan* plan, size_t* keyLength
+ * Returns: malloc'd key, NULL if the working directory is unknown
+ * Preconditions: plan != NULL, plan->argv != NULL
+ */
+static char* buildKey(struct launchPlan* plan, size_t* keyLength) {
+    size_t capacity = 4096;
+    size_t used = 0;
+    char* key = malloc(capacity);
+    char marker[32];
+    int i;
+
+    assert(key != NULL);
+    if (getcwd(key, capacity) == NULL) { free(key); return NULL; }
+    used = strlen(key) + 1;
+
+    for (i = 0; i < plan->argc; i++) {
+        appendKey(&key, &used, &capacity, plan->argv[i], strlen(plan->argv[i]));
+    }
+    if (plan->inFile != NULL) { appendIdentity(&key, &used, &capacity, "<", plan->inFile); }
+    if (plan->hereText != NULL) {
+        appendKey(&key, &used, &capacity, plan->hereString ? "<<<" : "<<", plan->hereString ? 3 : 2);
+        appendKey(&key, &used, &capacity, plan->hereText, strlen(plan->hereText));    //The text is the input, not a file
+    }
+    for (i = 1; i < plan->argc; i++) {
+        sprintf(marker, "@%d", i);
+        appendIdentity(&key, &used, &capacity, marker, plan->argv[i]);
+    }
+    *keyLength = used;
+    return key;
+}
+
+/*            hashKey
+ * Description: FNV-1a 64 bit hash of the key.
+ * Parameters: char* key, size_t length
+ * Returns: hash
+ * Preconditions: key != NULL
+ */
+static unsigned long long hashKey(char* key, size_t length) {
+    unsigned long long h = 14695981039346656037ull;
+    size_t i;
+    for (i = 0; i < length; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/*            replayEntry
+ * Description: Copies the stored stdout of the entry open on fd to outFile, or to the shell's stdout when outFile is NULL. sendfile refuses
+ *         an O_APPEND stdout, that one is copied through a buffer.
+ * Parameters: int fd, off_t length, char* outFile
+ * Returns: 0 on success, -1 on error
+ * Preconditions: fd is an open entry
+ */
+static int replayEntry(int fd, off_t length, char* outFile) {
+    off_t offset = 0;
+    ssize_t sent;
+    int outFd = STDOUT_FILENO;
+    char buffer[65536];
+
+    if (outFile != NULL) {
+        outFd = open(outFile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);    //Same as a > redirection
+        if (outFd == -1) { perror("open() error\n"); return -1; }
+    } else {
+        fflush(stdout);    //Keep shell output in order with the replayed output
+    }
+
+    while (offset < length) {
+        sent = sendfile(outFd, fd, &offset, length - offset);
+        if (sent == -1 && errno == EINVAL) {
+            sent = pread(fd, buffer, length - offset < (off_t)sizeof(buffer) ? length - offset : (off_t)sizeof(buffer), offset);
+            if (sent > 0 && (sent = write(outFd, buffer, sent)) > 0) { offset += sent; }
+        }
+        if (sent == -1 && errno == EINTR) { continue; }
+        if (sent <= 0) {
+            if (sent == -1) { perror("sendfile() error\n"); }
+            break;
+        }
+    }
+    if (outFd != STDOUT_FILENO) { close(outFd); }
+    return offset == length ? 0 : -1;
+}
+
+/*            openEntry
+ * Description: Opens the entry at path and checks its trailer and key.
+ * Parameters: char* path, char* key, size_t keyLength, struct cacheTrailer* trailer
+ * Returns: descriptor of a matching entry, -1 if there is none
+ * Preconditions: path != NULL, key != NULL, trailer != NULL
+ */
+static int openEntry(char* path, char* key, size_t keyLength, struct cacheTrailer* trailer) {
+    struct stat info;
+    char* stored;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd == -1) { return -1; }
+    if (fstat(fd, &info) == -1 || info.st_size < (off_t)sizeof(*trailer) ||
+        pread(fd, trailer, sizeof(*trailer), info.st_size - sizeof(*trailer)) != sizeof(*trailer) ||
+        trailer->magic != CACHE_MAGIC || trailer->keyLength != keyLength ||
+        trailer->outLength + keyLength + sizeof(*trailer) != (unsigned long long)info.st_size) {
+        close(fd);
+        return -1;
+    }
+
+    stored = malloc(keyLength);
+    assert(stored != NULL);
+    if (pread(fd, stored, keyLength, trailer->outLength) != (ssize_t)keyLength || memcmp(stored, key, keyLength) != 0) {
+        close(fd);    //Another key with the same hash
+        fd = -1;
+    }
+    free(stored);
+    return fd;
+}
+
+/*            compareUse
+ * Description: qsort comparison putting the least recently used entry first.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at struct cacheFile
+ */
+static int compareUse(const void* a, const void* b) {
+    const struct cacheFile* x = a;
+    const struct cacheFile* y = b;
+    if (x->used.tv_sec != y->used.tv_sec) { return x->used.tv_sec < y->used.tv_sec ? -1 : 1; }
+    if (x->used.tv_nsec != y->used.tv_nsec) { return x->used.tv_nsec < y->used.tv_nsec ? -1 : 1; }
+    return 0;
+}
+
+/*            scanEntries
+ * Description: Lists the entries of the cache directory, names are 16 hex digits.
+ * Parameters: char* dir, int* count, off_t* total
+ * Returns: malloc'd array of entries, count and total bytes are updated by reference
+ * Preconditions: dir != NULL
+ */
+static struct cacheFile* scanEntries(char* dir, int* count, off_t* total) {
+    struct cacheFile* files = NULL;
+    struct dirent* entry;
+    struct stat info;
+    int capacity = 0;
+    DIR* d = opendir(dir);
+    int fd;
+
+    *count = 0;
+    *total = 0;
+    if (d == NULL) { return NULL; }
+    fd = dirfd(d);
+    while ((entry = readdir(d)) != NULL) {
+        if (strlen(entry->d_name) != 16 || strspn(entry->d_name, "0123456789abcdef") != 16) { continue; }
+        if (fstatat(fd, entry->d_name, &info, 0) == -1) { continue; }
+        if (*count == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            files = realloc(files, capacity * sizeof(struct cacheFile));
+            assert(files != NULL);
+        }
+        strcpy(files[*count].name, entry->d_name);
+        files[*count].size = info.st_size;
+        files[*count].used = info.st_mtim;
+        *total += info.st_size;
+        (*count)++;
+    }
+    closedir(d);
+    return files;
+}
+
+/*            evictEntries
+ * Description: Removes the least recently used entries until the directory holds at most SHELLLITE_CACHE_SIZE bytes.
+ * Parameters: char* dir
+ * Returns: void
+ * Preconditions: dir != NULL
+ */
+static void evictEntries(char* dir) {
+    char* setting = getenv("SHELLLITE_CACHE_SIZE");
+    off_t limit = setting != NULL ? atoll(setting) : CACHE_DEFAULT_SIZE;
+    off_t total;
+    int count, i;
+    int dirFd;
+    struct cacheFile* files = scanEntries(dir, &count, &total);
+
+    if (total > limit && (dirFd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) != -1) {
+        qsort(files, count, sizeof(struct cacheFile), compareUse);
+        for (i = 0; i < count && total > limit; i++) {
+            if (unlinkat(dirFd, files[i].name, 0) == 0) {
+                total -= files[i].size;
+                cacheEvictions++;
+            }
+        }
+        close(dirFd);
+    }
+    free(files);
+}
+
+/*            printCacheStats
+ * Description: Prints the hit rate of this shell and the size of the cache directory.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+static void printCacheStats(void) {
+    char* dir = cacheDirectory();
+    long lookups = cacheHits + cacheMisses;
+    off_t total = 0;
+    int count = 0;
+
+    if (dir != NULL) { free(scanEntries(dir, &count, &total)); }
+    printf("cache: %ld hits, %ld misses, %.1f%% hit rate, %ld evicted\n", cacheHits, cacheMisses,
+           lookups > 0 ? 100.0 * cacheHits / lookups : 0.0, cacheEvictions);
+    printf("cache: %d entries, %lld bytes in %s\n", count, (long long)total, dir != NULL ? dir : "(none)");
+}
+
+/*            storeEntry
+ * Description: Runs args through commandLauncher with stdout sent to a temporary file, then publishes it as the entry at path if the command
+ *         exited normally. The output of a command that is not stored is still returned for replaying, its file is already unlinked.
+ * Parameters: char** args, int count, char* outFile, char* path, char* key, size_t keyLength, off_t* outLength, struct process* lastForeground,
+ *         struct jobTable* jobs
+ * Returns: descriptor of the captured output, outLength is updated by reference, -1 if the command did not run
+ * Preconditions: args is the line without the cache prefix, count >= 1
+ */
+static int storeEntry(char** args, int count, char* outFile, char* path, char* key, size_t keyLength, off_t* outLength,
+                      struct process* lastForeground, struct jobTable* jobs) {
+    struct cacheTrailer trailer;
+    struct stat info;
+    char* temp = malloc(strlen(path) + 8);
+    char** run = malloc((count + 3) * sizeof(char*));
+    int runCount = 0;
+    int published = 0;
+    int fd, i;
+
+    assert(temp != NULL && run != NULL);
+    sprintf(temp, "%s.XXXXXX", path);
+    fd = mkstemp(temp);
+    if (fd == -1) {
+        perror("cache mkstemp() error\n");
+        free(temp);
+        free(run);
+        commandLauncher(args, &count, lastForeground, jobs);    //Run it uncached
+        return -1;
+    }
+    close(fd);
+
+    /* Same line with > pointing at the temporary file */
+    for (i = 0; i < count; i++) {
+        run[runCount++] = args[i];
+        if (strcmp(args[i], ">") == 0) { run[runCount++] = temp; i++; }
+    }
+    if (outFile == NULL) {
+        run[runCount++] = ">";
+        run[runCount++] = temp;
+    }
+    run[runCount] = NULL;
+
+    initProcess(lastForeground);
+    commandLauncher(run, &runCount, lastForeground, jobs);
+    free(run);
+
+    fd = -1;
+    if (lastForeground->done) { fd = open(temp, O_RDWR | O_APPEND | O_CLOEXEC); }
+    if (fd != -1 && fstat(fd, &info) == 0) {
+        *outLength = info.st_size;
+
+        /* Keep only commands that exited, a signal says nothing about the output */
+        if (lastForeground->exitValue >= 0 && lastForeground->signalValue < 0) {
+            trailer.magic = CACHE_MAGIC;
+            trailer.exitValue = lastForeground->exitValue;
+            trailer.outLength = info.st_size;
+            trailer.keyLength = keyLength;
+            if (write(fd, key, keyLength) == (ssize_t)keyLength && write(fd, &trailer, sizeof(trailer)) == sizeof(trailer) &&
+                rename(temp, path) == 0) {
+                published = 1;
+            } else {
+                perror("cache write() error\n");
+            }
+        }
+    } else if (fd != -1) {
+        close(fd);
+        fd = -1;
+    }
+    if (!published) { unlink(temp); }
+    free(temp);
+    return fd;
+}
+
+/*            cacheCommand
+ * Description: The cache builtin. Looks up the command on the rest of the line, a hit replays the stored stdout and exit value, a miss runs
+ *         the command, stores its stdout and replays it. Background commands and commands with >+ run uncached, pipelines are refused. cache --stats prints the hit rate.
+ * Parameters: char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, *aCount >= 1, lastForeground != NULL, jobs != NULL
+ */
+void cacheCommand(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && *aCount >= 1);
+    assert(lastForeground != NULL && jobs != NULL);
+
+    struct launchPlan plan;
+    struct cacheTrailer trailer;
+    off_t outLength = 0;         //Bytes of stdout to replay
+    struct timespec start;       //Lookup start, the wall clock time of a hit for time
+    int count = *aCount - 1;    //Arguments without the cache prefix
+    char* dir;
+    char* key;
+    char* path;
+    size_t keyLength;
+    int fd;
+
+    if (count == 1 && strcmp(args[1], "--stats") == 0) {
+        printCacheStats();
+        return;
+    }
+    if (count == 0) {
+        fprintf(stderr, "Usage: cache command [args...] [< in] [> out] | cache --stats\n");
+        return;
+    }
+    if (linearSearch(args + 1, "|", count) > -1) {
+        fprintf(stderr, "Error, cache does not support pipelines\n");
+        return;
+    }
+    if (buildLaunchPlan(args + 1, count, &plan) == -1) { return; }
+
+    dir = cacheDirectory();
+    key = plan.background || plan.teeCount > 0 || dir == NULL ? NULL : buildKey(&plan, &keyLength);
+    if (key == NULL) {
+        closeLaunchPlan(&plan);
+        commandLauncher(args + 1, &count, lastForeground, jobs);    //Nothing to key on, run it as usual
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    path = malloc(strlen(dir) + 18);
+    assert(path != NULL);
+    sprintf(path, "%s/%016llx", dir, hashKey(key, keyLength));
+
+    fd = openEntry(path, key, keyLength, &trailer);
+    if (fd != -1) {
+        cacheHits++;
+        futimens(fd, NULL);    //Most recently used
+        initProcess(lastForeground);
+        lastForeground->exitValue = trailer.exitValue;
+        lastForeground->done = 1;
+        lastForeground->start = start;
+        outLength = trailer.outLength;
+    } else {
+        cacheMisses++;
+        fd = storeEntry(args + 1, count, plan.outFile, path, key, keyLength, &outLength, lastForeground, jobs);
+        evictEntries(dir);
+    }
+
+    if (fd != -1) {
+        if (replayEntry(fd, outLength, plan.outFile) == -1) { lastForeground->exitValue = 1; }
+        close(fd);
+        if (lastForeground->pid == 0) { clock_gettime(CLOCK_MONOTONIC, &lastForeground->end); }
+    }
+    free(path);
+    free(key);
+    closeLaunchPlan(&plan);
+}
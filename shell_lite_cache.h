@@ -0,0 +1,26 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_cache.h
+* Description: This is the function declaration file for the output cache of the shellLite shell. The cache prefix runs a
+*              deterministic command once and replays its stdout and exit value afterwards, without forking:
+*                  cache command [args...] [< in] [> out]
+*                  cache --stats
+*              The key is the working directory, argv and the identity (dev, inode, size, mtime) of the < input and of every
+*              argument naming an existing file. Entries live in SHELLLITE_CACHE_DIR, $HOME/.shellLite_cache by default, and the
+*              least recently used ones are removed once the directory holds more than SHELLLITE_CACHE_SIZE bytes.
+* Citations:
+*         1. Fowler, Noll, Vo "FNV hash", Assisted with the key hash.
+*/
+#ifndef shell_lite_cache_h
+#define shell_lite_cache_h
+
+#include "shell_lite_launch.h"
+#include <sys/stat.h>
+
+#define CACHE_DEFAULT_SIZE 67108864    //Bytes kept on disk without SHELLLITE_CACHE_SIZE
+#define CACHE_MAGIC 0x53484c43u        //Marks a complete entry
+
+void cacheCommand(char**, int*, struct process*, struct jobTable*);    //Runs the cache builtin
+
+#endif /* shell_lite_cache_h */
@@ -0,0 +1,163 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_fanout.c
+* Description: This is the function implementation file for output fan-out in the shellLite shell. For every block in the
+*              command's pipe the relay tees it into a second pipe and splices that into one destination, once per
+*              destination but the last, then splices the block itself into the last destination, which consumes it.
+*              tee only references the pipe pages, so every byte is copied by the kernel once per file it lands in.
+* Citations:
+*         1. tee(2) and splice(2) Linux manual pages, Assisted with duplicating and moving pipe data.
+*         2. close_range(2) Linux manual page, Assisted with dropping the shell's descriptors in the relay.
+*/
+#include "shell_lite_fanout.h"
+
+/*            moveBytes
+ * Description: Moves length bytes from the pipe from to fd with splice. Destinations splice cannot write to (terminals, O_APPEND files) are
+ *         served through buffer instead. A destination that fails is reported once and its data discarded from then on.
+ * Parameters: int from, int fd, size_t length, char** buffer, int* dead
+ * Returns: void
+ * Preconditions: from is a pipe holding at least length bytes
+ */
+static void moveBytes(int from, int fd, size_t length, char** buffer, int* dead) {
+    ssize_t moved;
+
+    while (length > 0) {
+        moved = *dead ? -1 : splice(from, NULL, fd, NULL, length, SPLICE_F_MOVE);
+        if (moved == -1 && !*dead && errno == EINTR) { continue; }
+        if (moved == -1 && !*dead && errno != EINVAL) {
+            perror(">+ splice() error\n");
+            *dead = 1;
+        }
+        if (moved == -1) {
+            /* No splice support or a dead destination, go through user space */
+            if (*buffer == NULL) {
+                *buffer = malloc(FANOUT_COPY_SIZE);
+                if (*buffer == NULL) { _exit(1); }
+            }
+            moved = read(from, *buffer, length < FANOUT_COPY_SIZE ? length : FANOUT_COPY_SIZE);
+            if (moved > 0 && !*dead && write(fd, *buffer, moved) != moved) {
+                perror(">+ write() error\n");
+                *dead = 1;
+            }
+        }
+        if (moved <= 0) { return; }
+        length -= moved;
+    }
+}
+
+/*            relayMain
+ * Description: Body of the relay. Copies the pipe in to the count descriptors in fds until the command closes its end.
+ * Parameters: int in, int* fds, int count
+ * Returns: never
+ * Preconditions: in is the read end of the command's pipe, count >= 2
+ */
+__attribute__((noreturn)) static void relayMain(int in, int* fds, int count) {
+    char* buffer = NULL;
+    int* dead = calloc(count, sizeof(int));    //Destinations that failed
+    int copy[2];    //Second pipe tee fills for every destination but the last
+    ssize_t length, teed;
+    int i;
+
+    if (dead == NULL || pipe2(copy, O_CLOEXEC) == -1) { perror(">+ pipe() error\n"); _exit(1); }
+    fcntl(copy[1], F_SETPIPE_SZ, FANOUT_PIPE_SIZE);
+
+    while (1) {
+        /* The first tee waits for data and sets the block size, later ones see the same bytes */
+        length = 0;
+        for (i = 0; i < count - 1; i++) {
+            do {
+                teed = tee(in, copy[1], length > 0 ? (size_t)length : FANOUT_PIPE_SIZE, 0);
+            } while (teed == -1 && errno == EINTR);
+            if (teed == -1) { perror(">+ tee() error\n"); _exit(1); }
+            if (teed == 0) { _exit(0); }    //Command closed its end
+            if (length > 0 && teed != length) {
+                fprintf(stderr, ">+ tee() copied %zd of %zd bytes\n", teed, length);    //Copy pipe is as large as the command's pipe
+                _exit(1);
+            }
+            length = teed;
+            moveBytes(copy[0], fds[i], length, &buffer, &dead[i]);
+        }
+        moveBytes(in, fds[count - 1], length, &buffer, &dead[count - 1]);
+    }
+}
+
+/*            compareFds
+ * Description: qsort comparison for descriptors.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at int
+ */
+static int compareFds(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+/*            startFanOut
+ * Description: This function opens the >+ targets of plan like > does and forks the relay. The relay writes to the plan's stdout target, or the
+ *         shell's stdout, and to every >+ target, the plan's stdout becomes the write end of the relay's pipe. The relay keeps only the
+ *         descriptors it copies between and stays in the shell's signal state, so CTRL-C ends the command and the relay drains what is left.
+ *         For a background plan the relay starts the job's process group and plan->pgid is set so the command joins it.
+ * Parameters: struct launchPlan* plan
+ * Returns: pid of the relay, -1 on error
+ * Preconditions: plan != NULL, plan->teeCount > 0, openLaunchPlan succeeded
+ */
+pid_t startFanOut(struct launchPlan* plan) {
+    assert(plan != NULL && plan->teeCount > 0);
+
+    int count = plan->teeCount + 1;
+    int* fds = malloc(count * sizeof(int));
+    int* keep = malloc((count + 1) * sizeof(int));
+    int pipeFds[2];
+    int i, next;
+    pid_t pid = -1;
+
+    assert(fds != NULL && keep != NULL);
+    fds[0] = plan->outFd != -1 ? plan->outFd : STDOUT_FILENO;
+    for (i = 1; i < count; i++) {
+        fds[i] = open(plan->teeFiles[i - 1], O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);    //Same as >
+        if (fds[i] == -1) { perror("open() error\n"); break; }
+    }
+
+    if (i == count && pipe2(pipeFds, O_CLOEXEC) == 0) {
+        fcntl(pipeFds[1], F_SETPIPE_SZ, FANOUT_PIPE_SIZE);
+        fflush(NULL);
+        pid = fork();
+        switch (pid) {
+            case -1: {perror("Error with fork in startFanOut\n"); close(pipeFds[0]); close(pipeFds[1]); break;}
+
+            case 0: {
+                    if (plan->pgid == 0) { setpgid(0, 0); }    //Background, the relay leads the job's group
+                    /* Close every descriptor above stderr the relay does not copy between */
+                    keep[0] = pipeFds[0];
+                    memcpy(keep + 1, fds, count * sizeof(int));
+                    qsort(keep, count + 1, sizeof(int), compareFds);
+                    for (i = 0, next = 3; i <= count; i++) {
+                        if (keep[i] > next) { close_range(next, keep[i] - 1, 0); }
+                        if (keep[i] + 1 > next) { next = keep[i] + 1; }
+                    }
+                    close_range(next, ~0U, 0);
+                    relayMain(pipeFds[0], fds, count);
+                }
+
+            default: {
+                    if (plan->pgid == 0) {
+                        setpgid(pid, pid);    //Set from the shell too, like forkCommand
+                        plan->pgid = pid;     //The command joins the relay's group
+                    }
+                    close(pipeFds[0]);
+                    if (plan->outFd != -1) { close(plan->outFd); }
+                    plan->outFd = pipeFds[1];    //The command writes into the relay
+                    break;
+                }
+        }
+    } else if (i == count) {
+        perror("pipe() error\n");
+    }
+
+    for (i = i == count ? count - 1 : i - 1; i >= 1; i--) {
+        close(fds[i]);    //The relay has its own copies
+    }
+    free(fds);
+    free(keep);
+    return pid;
+}
@@ -0,0 +1,22 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_fanout.h
+* Description: This is the function declaration file for output fan-out in the shellLite shell. command >+ a.log >+ b.log
+*              sends the command's stdout to its usual place (the terminal or the > target) and to a.log and b.log. The
+*              command writes into a pipe read by a relay process the shell forks, which copies the stream to every
+*              destination with tee(2) and splice(2) so the data never passes through user space.
+* Citations:
+*         1. tee(2) and splice(2) Linux manual pages, Assisted with duplicating and moving pipe data.
+*/
+#ifndef shell_lite_fanout_h
+#define shell_lite_fanout_h
+
+#include "shell_lite_launch.h"
+
+#define FANOUT_PIPE_SIZE 1048576    //Capacity asked for the command's pipe and the relay's copy pipe
+#define FANOUT_COPY_SIZE 65536      //Buffer for destinations splice cannot write to, like terminals
+
+pid_t startFanOut(struct launchPlan*);    //Forks the relay and points the plan's stdout at it
+
+#endif /* shell_lite_fanout_h */
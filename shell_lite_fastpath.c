@@ -0,0 +1,365 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_fastpath.c
+* Description: This is the function implementation file for the in-process fast path of the shellLite shell. Every utility is
+*              a function in the dispatch table returning its exit status, or FASTPATH_FALLBACK before any output was made
+*              when the real program has to run instead.
+* Citations:
+*         1. The Open Group "test" and "printf" utility specifications, Assisted with the argument rules of test and printf.
+*/
+#include "shell_lite_fastpath.h"
+#include "shell_lite_stats.h"
+
+static char* output = NULL;       //Output of the running utility
+static size_t outputLength = 0;   //Bytes used in output
+static size_t outputCapacity = 0; //Bytes allocated for output
+
+/*            emit
+ * Description: Appends length bytes of text to the output buffer, doubling it as needed.
+ * Parameters: const char* text, size_t length
+ * Returns: void
+ * Preconditions: text != NULL
+ */
+static void emit(const char* text, size_t length) {
+    if (outputLength + length > outputCapacity) {
+        outputCapacity = outputCapacity ? outputCapacity * 2 : 256;
+        while (outputLength + length > outputCapacity) { outputCapacity *= 2; }
+        output = realloc(output, outputCapacity);
+        assert(output != NULL);
+    }
+    memcpy(output + outputLength, text, length);
+    outputLength += length;
+}
+
+/*            isHelp
+ * Description: Returns 1 for a lone --help or --version argument, which GNU utilities answer with their own text.
+ * Parameters: char** argv, int argc
+ * Returns: 1 or 0
+ * Preconditions: argv != NULL
+ */
+static int isHelp(char** argv, int argc) {
+    return argc == 2 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "--version") == 0);
+}
+
+/*            parseInteger
+ * Description: Parses text as a whole decimal integer.
+ * Parameters: char* text, long long* value
+ * Returns: 0 on success, -1 if text is not an integer
+ * Preconditions: text != NULL, value != NULL
+ */
+static int parseInteger(char* text, long long* value) {
+    char* end;
+    errno = 0;
+    *value = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE) { return -1; }
+    return 0;
+}
+
+/*            fastTrue
+ * Description: true, always succeeds.
+ * Parameters: char** argv, int argc
+ * Returns: exit status, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 1
+ */
+static int fastTrue(char** argv, int argc) {
+    return isHelp(argv, argc) ? FASTPATH_FALLBACK : 0;
+}
+
+/*            fastFalse
+ * Description: false, always fails.
+ * Parameters: char** argv, int argc
+ * Returns: exit status, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 1
+ */
+static int fastFalse(char** argv, int argc) {
+    return isHelp(argv, argc) ? FASTPATH_FALLBACK : 1;
+}
+
+/*            fastEcho
+ * Description: echo with -n and -E. -e needs escape handling and is left to the real echo.
+ * Parameters: char** argv, int argc
+ * Returns: exit status, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 1
+ */
+static int fastEcho(char** argv, int argc) {
+    int i = 1;
+    int newline = 1;    //0 after -n
+    char* c;
+
+    if (isHelp(argv, argc)) { return FASTPATH_FALLBACK; }
+
+    /* Leading arguments made only of n, e and E are options */
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        for (c = argv[i] + 1; *c == 'n' || *c == 'E'; c++) { }
+        if (*c == 'e') { return FASTPATH_FALLBACK; }
+        if (*c != '\0') { break; }    //Not an option, printed as is
+        if (strchr(argv[i], 'n') != NULL) { newline = 0; }
+    }
+
+    for (; i < argc; i++) {
+        emit(argv[i], strlen(argv[i]));
+        if (i < argc - 1) { emit(" ", 1); }
+    }
+    if (newline) { emit("\n", 1); }
+    return 0;
+}
+
+/*            fastPrintf
+ * Description: printf with the %s, %d, %i, %u, %c and %% conversions and the common backslash escapes. The format is reused while arguments
+ *         remain. Field widths, precisions, flags, other conversions and numeric escapes are left to the real printf.
+ * Parameters: char** argv, int argc
+ * Returns: exit status, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 1
+ */
+static int fastPrintf(char** argv, int argc) {
+    char* format;
+    char* f;
+    int next = 2;    //Next argument to convert
+    int converted;   //1 if the format consumed an argument this pass
+    long long number;
+    char text[32];
+
+    if (argc < 2 || isHelp(argv, argc)) { return FASTPATH_FALLBACK; }
+    format = argv[1];
+
+    do {
+        converted = 0;
+        for (f = format; *f != '\0'; f++) {
+            if (*f == '\\') {
+                f++;
+                switch (*f) {
+                    case 'n': emit("\n", 1); break;
+                    case 't': emit("\t", 1); break;
+                    case 'r': emit("\r", 1); break;
+                    case 'a': emit("\a", 1); break;
+                    case 'b': emit("\b", 1); break;
+                    case 'f': emit("\f", 1); break;
+                    case 'v': emit("\v", 1); break;
+                    case '\\': emit("\\", 1); break;
+                    case '"': emit("\"", 1); break;
+                    case '\'': emit("'", 1); break;
+                    default: return FASTPATH_FALLBACK;    //Octal, hex, unicode or a trailing backslash
+                }
+            } else if (*f == '%') {
+                f++;
+                if (*f == '%') { emit("%", 1); continue; }
+                char* arg = next < argc ? argv[next] : NULL;
+                switch (*f) {
+                    case 's':
+                        if (arg != NULL) { emit(arg, strlen(arg)); }
+                        break;
+                    case 'c':
+                        if (arg != NULL && arg[0] != '\0') { emit(arg, 1); }
+                        break;
+                    case 'd': case 'i': case 'u':
+                        number = 0;
+                        if (arg != NULL && parseInteger(arg, &number) == -1) { return FASTPATH_FALLBACK; }
+                        if (*f == 'u' && number < 0) { return FASTPATH_FALLBACK; }
+                        emit(text, snprintf(text, sizeof(text), "%lld", number));
+                        break;
+                    default: return FASTPATH_FALLBACK;    //Flags, widths and other conversions
+                }
+                converted = 1;
+                next++;
+            } else {
+                emit(f, 1);
+            }
+        }
+    } while (converted && next < argc);
+
+    return 0;
+}
+
+/*            unaryTest
+ * Description: Evaluates test's unary primary op on operand.
+ * Parameters: char* op, char* operand
+ * Returns: 0 true, 1 false, FASTPATH_FALLBACK if op is not supported
+ * Preconditions: op != NULL, operand != NULL
+ */
+static int unaryTest(char* op, char* operand) {
+    struct stat info;
+    int found;
+
+    if (op[0] != '-' || op[1] == '\0' || op[2] != '\0') { return FASTPATH_FALLBACK; }
+    switch (op[1]) {
+        case 'n': return operand[0] != '\0' ? 0 : 1;
+        case 'z': return operand[0] == '\0' ? 0 : 1;
+        case 'r': return access(operand, R_OK) == 0 ? 0 : 1;
+        case 'w': return access(operand, W_OK) == 0 ? 0 : 1;
+        case 'x': return access(operand, X_OK) == 0 ? 0 : 1;
+        case 'L': case 'h': return lstat(operand, &info) == 0 && S_ISLNK(info.st_mode) ? 0 : 1;
+    }
+
+    found = stat(operand, &info) == 0;
+    switch (op[1]) {
+        case 'e': return found ? 0 : 1;
+        case 'f': return found && S_ISREG(info.st_mode) ? 0 : 1;
+        case 'd': return found && S_ISDIR(info.st_mode) ? 0 : 1;
+        case 's': return found && info.st_size > 0 ? 0 : 1;
+        case 'b': return found && S_ISBLK(info.st_mode) ? 0 : 1;
+        case 'c': return found && S_ISCHR(info.st_mode) ? 0 : 1;
+        case 'p': return found && S_ISFIFO(info.st_mode) ? 0 : 1;
+        case 'S': return found && S_ISSOCK(info.st_mode) ? 0 : 1;
+    }
+    return FASTPATH_FALLBACK;
+}
+
+/*            binaryTest
+ * Description: Evaluates test's binary primary op on left and right.
+ * Parameters: char* left, char* op, char* right
+ * Returns: 0 true, 1 false, FASTPATH_FALLBACK if op is not a binary primary or an operand is not an integer
+ * Preconditions: left != NULL, op != NULL, right != NULL
+ */
+static int binaryTest(char* left, char* op, char* right) {
+    long long a, b;
+
+    if (strcmp(op, "=") == 0 || strcmp(op, "==") == 0) { return strcmp(left, right) == 0 ? 0 : 1; }
+    if (strcmp(op, "!=") == 0) { return strcmp(left, right) != 0 ? 0 : 1; }
+    if (strcmp(op, "-a") == 0) { return left[0] != '\0' && right[0] != '\0' ? 0 : 1; }
+    if (strcmp(op, "-o") == 0) { return left[0] != '\0' || right[0] != '\0' ? 0 : 1; }
+
+    if (op[0] != '-' || strlen(op) != 3) { return FASTPATH_FALLBACK; }
+    if (parseInteger(left, &a) == -1 || parseInteger(right, &b) == -1) { return FASTPATH_FALLBACK; }
+    if (strcmp(op, "-eq") == 0) { return a == b ? 0 : 1; }
+    if (strcmp(op, "-ne") == 0) { return a != b ? 0 : 1; }
+    if (strcmp(op, "-lt") == 0) { return a < b ? 0 : 1; }
+    if (strcmp(op, "-le") == 0) { return a <= b ? 0 : 1; }
+    if (strcmp(op, "-gt") == 0) { return a > b ? 0 : 1; }
+    if (strcmp(op, "-ge") == 0) { return a >= b ? 0 : 1; }
+    return FASTPATH_FALLBACK;
+}
+
+/*            negate
+ * Description: Inverts a test result, FASTPATH_FALLBACK passes through.
+ * Parameters: int result
+ * Returns: 0 true, 1 false, FASTPATH_FALLBACK
+ * Preconditions: N/A
+ */
+static int negate(int result) {
+    return result == FASTPATH_FALLBACK ? result : !result;
+}
+
+/*            testExpression
+ * Description: Evaluates up to 4 test arguments with the POSIX rules that decide by argument count. Longer expressions are left to the real test.
+ * Parameters: char** argv, int argc
+ * Returns: 0 true, 1 false, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 0
+ */
+static int testExpression(char** argv, int argc) {
+    int result;
+
+    switch (argc) {
+        case 0: return 1;
+        case 1: return argv[0][0] != '\0' ? 0 : 1;
+        case 2:
+            if (strcmp(argv[0], "!") == 0) { return testExpression(argv + 1, 1) == 0 ? 1 : 0; }
+            return unaryTest(argv[0], argv[1]);
+        case 3:
+            result = binaryTest(argv[0], argv[1], argv[2]);
+            if (result != FASTPATH_FALLBACK) { return result; }
+            if (strcmp(argv[0], "!") == 0) { return negate(testExpression(argv + 1, 2)); }
+            if (strcmp(argv[0], "(") == 0 && strcmp(argv[2], ")") == 0) { return testExpression(argv + 1, 1); }
+            return FASTPATH_FALLBACK;
+        case 4:
+            if (strcmp(argv[0], "!") == 0) { return negate(testExpression(argv + 1, 3)); }
+            if (strcmp(argv[0], "(") == 0 && strcmp(argv[3], ")") == 0) { return testExpression(argv + 1, 2); }
+            return FASTPATH_FALLBACK;
+    }
+    return FASTPATH_FALLBACK;
+}
+
+/*            fastTest
+ * Description: test and [. [ needs ] as its last argument.
+ * Parameters: char** argv, int argc
+ * Returns: exit status, FASTPATH_FALLBACK
+ * Preconditions: argv != NULL, argc >= 1
+ */
+static int fastTest(char** argv, int argc) {
+    if (strcmp(argv[0], "[") == 0) {
+        if (isHelp(argv, argc) || strcmp(argv[argc - 1], "]") != 0) { return FASTPATH_FALLBACK; }
+        argc--;
+    }
+    return testExpression(argv + 1, argc - 1);
+}
+
+                            /* Struct for one entry of the dispatch table */
+struct fastPath {
+    const char* name;              //Command name as typed
+    int (*run)(char**, int);       //Returns the exit status or FASTPATH_FALLBACK
+};
+
+static struct fastPath fastPaths[] = {
+    { "echo", fastEcho },
+    { "true", fastTrue },
+    { "false", fastFalse },
+    { "printf", fastPrintf },
+    { "test", fastTest },
+    { "[", fastTest },
+    { NULL, NULL }
+};
+
+/*            writeAll
+ * Description: Writes length bytes of text to fd, retrying short writes.
+ * Parameters: int fd, char* text, size_t length
+ * Returns: 0 on success, -1 on error
+ * Preconditions: fd >= 0, text != NULL
+ */
+static int writeAll(int fd, char* text, size_t length) {
+    ssize_t written;
+    while (length > 0) {
+        written = write(fd, text, length);
+        if (written == -1) {
+            if (errno == EINTR) { continue; }
+            return -1;
+        }
+        text += written;
+        length -= written;
+    }
+    return 0;
+}
+
+/*            fastPathCommand
+ * Description: This function runs a foreground plan inside the shell if its command is in the dispatch table and accepts its arguments.
+ *         Redirection targets are opened the same way as for a child, output is written to the > target or appended to the shell's stdout
+ *         buffer. lastForeground is updated so status reports the utility's exit value.
+ * Parameters: struct launchPlan* plan, struct process* lastForeground
+ * Returns: 0 if the command ran in the shell, -1 if it has to be exec'd
+ * Preconditions: plan != NULL, plan->argv != NULL, lastForeground != NULL
+ */
+int fastPathCommand(struct launchPlan* plan, struct process* lastForeground) {
+    assert(plan != NULL && plan->argv != NULL && lastForeground != NULL);
+
+    struct fastPath* fp;
+    struct timespec start;
+    char* setting = getenv("SHELLLITE_FASTPATH");
+    int result;
+
+    if (plan->background || plan->limited || plan->teeCount > 0 || (setting != NULL && strcmp(setting, "0") == 0)) { return -1; }
+    for (fp = fastPaths; fp->name != NULL && strcmp(fp->name, plan->argv[0]) != 0; fp++) { }
+    if (fp->name == NULL) { return -1; }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    outputLength = 0;
+    result = fp->run(plan->argv, plan->argc);
+    if (result == FASTPATH_FALLBACK) { return -1; }
+
+    if (openLaunchPlan(plan) == -1) {
+        result = 1;    //Same as a child whose redirection failed
+    } else if (plan->outFd != -1) {
+        if (writeAll(plan->outFd, output, outputLength) == -1) {
+            perror("write() error\n");
+            result = 1;
+        }
+    } else {
+        fwrite(output, 1, outputLength, stdout);
+    }
+
+    initProcess(lastForeground);
+    lastForeground->exitValue = result;
+    lastForeground->done = 1;
+    lastForeground->start = start;
+    clock_gettime(CLOCK_MONOTONIC, &lastForeground->end);
+    statsCount(STATS_COMMANDS);
+    return 0;
+}
@@ -0,0 +1,23 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_fastpath.h
+* Description: This is the function declaration file for the in-process fast path of the shellLite shell. echo, true, false,
+*              printf, test and [ are run inside the shell when they are in the foreground, skipping fork and exec entirely.
+*              Each utility renders its output into a buffer first and gives up before producing anything when it meets an
+*              option or operand it does not support, the command is then exec'd as usual. Output goes to the > target if the
+*              command has one, otherwise into the shell's stdout buffer. SHELLLITE_FASTPATH=0 in the environment turns it off.
+* Citations:
+*         1. The Open Group "test" and "printf" utility specifications, Assisted with the argument rules of test and printf.
+*/
+#ifndef shell_lite_fastpath_h
+#define shell_lite_fastpath_h
+
+#include "shell_lite_launch.h"
+#include <sys/stat.h>
+
+#define FASTPATH_FALLBACK -1    //Returned by a utility that cannot handle its arguments
+
+int fastPathCommand(struct launchPlan*, struct process*);    //Runs plan inside the shell, returns -1 if it must be exec'd
+
+#endif /* shell_lite_fastpath_h */
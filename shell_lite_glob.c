@@ -0,0 +1,376 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_glob.c
+* Description: This is the function implementation file for filename expansion in the shellLite shell. Every pattern component
+*              is compiled once into an array of operations, classes become 256 bit maps, and matched against each name with
+*              the single backtrack point needed for *. Listings are malloc'd and freed when the line's expansion is done,
+*              only the matches are copied into the line arena.
+* Citations:
+*         1. getdents64(2) and glob(7) Linux manual pages, Assisted with reading directories and the pattern rules.
+*         2. Krauss, Kirk "Matching Wildcards: An Algorithm", Assisted with the matching loop.
+*/
+#include "shell_lite_glob.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+enum globOpType { GLOB_CHAR, GLOB_ANY, GLOB_STAR, GLOB_SET };
+
+                            /* Struct for one compiled pattern operation */
+struct globOp {
+    enum globOpType type;
+    unsigned char c;              //Character for GLOB_CHAR
+    unsigned char set[32];        //Bit map of matching bytes for GLOB_SET
+};
+
+                            /* Struct for a directory listing read during one line */
+struct globListing {
+    char* path;                   //Directory as given, "." for the current one
+    struct timespec mtime;        //mtime when it was read, a newer one means the listing is stale
+    char* data;                   //Null terminated names, packed
+    char** names;                 //Every name except . and ..
+    int count;                    //Number of names
+    struct globListing* next;
+};
+
+                            /* Struct for the growing list of matches of one pattern */
+struct globResults {
+    char** paths;
+    int count;
+    int capacity;
+};
+
+                            /* Layout of the records returned by getdents64 */
+struct linuxDirent64 {
+    unsigned long long d_ino;
+    long long d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+/*            compilePattern
+ * Description: Compiles one pattern component of length bytes. A [ without a closing ] is an ordinary character.
+ * Parameters: char* pattern, size_t length, struct globOp* ops
+ * Returns: number of operations, -1 if the component is too long; *hasMeta is set to 1 if any operation is not GLOB_CHAR
+ * Preconditions: pattern != NULL, ops holds GLOB_OPS_MAX entries
+ */
+static int compilePattern(char* pattern, size_t length, struct globOp* ops, int* hasMeta) {
+    size_t i = 0, j;
+    int n = 0;
+    int negate, c, last;
+
+    *hasMeta = 0;
+    while (i < length) {
+        if (n == GLOB_OPS_MAX) { return -1; }
+        if (pattern[i] == '*') {
+            if (n == 0 || ops[n - 1].type != GLOB_STAR) { ops[n++].type = GLOB_STAR; }    //** is the same as *
+            *hasMeta = 1;
+            i++;
+            continue;
+        }
+        if (pattern[i] == '?') {
+            ops[n++].type = GLOB_ANY;
+            *hasMeta = 1;
+            i++;
+            continue;
+        }
+        if (pattern[i] == '[') {
+            /* Find the closing ], a ] right after [ or [! belongs to the class */
+            j = i + 1;
+            if (j < length && (pattern[j] == '!' || pattern[j] == '^')) { j++; }
+            if (j < length && pattern[j] == ']') { j++; }
+            while (j < length && pattern[j] != ']') { j++; }
+            if (j < length) {
+                negate = (pattern[i + 1] == '!' || pattern[i + 1] == '^');
+                memset(ops[n].set, 0, sizeof(ops[n].set));
+                last = -1;
+                for (i = i + 1 + negate; i < j; i++) {
+                    c = (unsigned char)pattern[i];
+                    if (c == '-' && last >= 0 && i + 1 < j) {
+                        for (c = last; c <= (unsigned char)pattern[i + 1]; c++) { ops[n].set[c >> 3] |= 1 << (c & 7); }
+                        i++;
+                        last = -1;
+                        continue;
+                    }
+                    ops[n].set[c >> 3] |= 1 << (c & 7);
+                    last = c;
+                }
+                if (negate) {
+                    for (c = 0; c < 32; c++) { ops[n].set[c] = ~ops[n].set[c]; }
+                }
+                ops[n++].type = GLOB_SET;
+                *hasMeta = 1;
+                i = j + 1;
+                continue;
+            }
+        }
+        ops[n].type = GLOB_CHAR;
+        ops[n++].c = (unsigned char)pattern[i++];
+    }
+    return n;
+}
+
+/*            matchPattern
+ * Description: Matches name against a compiled component. On a mismatch after a * the * takes one more character and matching resumes there.
+ * Parameters: struct globOp* ops, int n, char* name
+ * Returns: 1 if name matches, 0 if not
+ * Preconditions: ops != NULL, name != NULL
+ */
+static int matchPattern(struct globOp* ops, int n, char* name) {
+    unsigned char* s = (unsigned char*)name;
+    unsigned char* starName = NULL;    //Name position the last * started matching at
+    int starOp = -1;                   //Operation after the last *
+    int p = 0;
+
+    while (*s != '\0') {
+        if (p < n && ops[p].type == GLOB_STAR) {
+            starOp = ++p;
+            starName = s;
+            continue;
+        }
+        if (p < n && (ops[p].type == GLOB_ANY || (ops[p].type == GLOB_CHAR && ops[p].c == *s) ||
+                      (ops[p].type == GLOB_SET && (ops[p].set[*s >> 3] & (1 << (*s & 7)))))) {
+            p++;
+            s++;
+            continue;
+        }
+        if (starOp < 0) { return 0; }
+        p = starOp;
+        s = ++starName;
+    }
+    while (p < n && ops[p].type == GLOB_STAR) { p++; }
+    return p == n;
+}
+
+/*            readListing
+ * Description: Reads directory path with getdents64 into a buffer of GLOB_DENTS_SIZE bytes and packs the names, without the record headers,
+ *         into one growing block, then indexes them. A listing already read during this line is reused while the directory's mtime is unchanged.
+ * Parameters: char* path, struct globListing** cache
+ * Returns: listing, NULL if path is not a readable directory
+ * Preconditions: path != NULL, cache != NULL
+ */
+static struct globListing* readListing(char* path, struct globListing** cache) {
+    static char* dents = NULL;    //getdents64 records, kept for later lines
+    struct globListing* listing;
+    struct linuxDirent64* entry;
+    struct stat info;
+    size_t capacity = GLOB_DENTS_SIZE;
+    size_t used = 0;
+    size_t offset, nameLength;
+    long numRead;
+    int fd, i;
+
+    fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd == -1) { return NULL; }
+    if (fstat(fd, &info) == -1) { close(fd); return NULL; }
+
+    for (listing = *cache; listing != NULL; listing = listing->next) {
+        if (strcmp(listing->path, path) == 0 && listing->mtime.tv_sec == info.st_mtim.tv_sec &&
+            listing->mtime.tv_nsec == info.st_mtim.tv_nsec) {
+            close(fd);
+            return listing;    //Unchanged since it was read
+        }
+    }
+
+    if (dents == NULL) {
+        dents = malloc(GLOB_DENTS_SIZE);
+        assert(dents != NULL);
+    }
+    listing = malloc(sizeof(struct globListing));
+    assert(listing != NULL);
+    listing->path = strdup(path);
+    listing->mtime = info.st_mtim;
+    listing->data = malloc(capacity);
+    listing->count = 0;
+    assert(listing->path != NULL && listing->data != NULL);
+
+    while ((numRead = syscall(SYS_getdents64, fd, dents, GLOB_DENTS_SIZE)) > 0) {
+        for (offset = 0; offset < (size_t)numRead; offset += entry->d_reclen) {
+            entry = (struct linuxDirent64*)(dents + offset);
+            if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0'))) { continue; }
+            nameLength = strlen(entry->d_name) + 1;
+            if (used + nameLength > capacity) {
+                capacity *= 2;
+                listing->data = realloc(listing->data, capacity);
+                assert(listing->data != NULL);
+            }
+            memcpy(listing->data + used, entry->d_name, nameLength);
+            used += nameLength;
+            listing->count++;
+        }
+    }
+    close(fd);
+
+    /* Index the names now that the block no longer moves */
+    listing->names = malloc((listing->count + 1) * sizeof(char*));
+    assert(listing->names != NULL);
+    for (i = 0, offset = 0; i < listing->count; i++) {
+        listing->names[i] = listing->data + offset;
+        offset += strlen(listing->data + offset) + 1;
+    }
+
+    listing->next = *cache;
+    *cache = listing;
+    return listing;
+}
+
+/*            addResult
+ * Description: Appends a copy of prefix followed by name to results, the copy lives in the line arena.
+ * Parameters: struct globResults* results, char* prefix, size_t prefixLength, char* name, struct arena* lineArena
+ * Returns: void
+ * Preconditions: results != NULL, prefix != NULL, name != NULL, lineArena != NULL
+ */
+static void addResult(struct globResults* results, char* prefix, size_t prefixLength, char* name, struct arena* lineArena) {
+    size_t nameLength = strlen(name);
+    char* path = arenaAlloc(lineArena, prefixLength + nameLength + 1);
+
+    memcpy(path, prefix, prefixLength);
+    memcpy(path + prefixLength, name, nameLength + 1);
+    if (results->count == results->capacity) {
+        results->capacity = results->capacity == 0 ? 64 : results->capacity * 2;
+        results->paths = realloc(results->paths, results->capacity * sizeof(char*));
+        assert(results->paths != NULL);
+    }
+    results->paths[results->count++] = path;
+}
+
+/*            expandPattern
+ * Description: Expands the components of pattern starting at component below the directory prefix. Literal components are appended without
+ *         reading the directory, the complete path is checked with lstat when the last component is literal.
+ * Parameters: char* prefix, char* component, struct globResults* results, struct globListing** cache, struct arena* lineArena
+ * Returns: void
+ * Preconditions: prefix ends with / or is empty, component != NULL
+ */
+static void expandPattern(char* prefix, char* component, struct globResults* results, struct globListing** cache, struct arena* lineArena) {
+    struct globOp ops[GLOB_OPS_MAX];
+    struct globListing* listing;
+    struct stat info;
+    char* slash = strchr(component, '/');
+    size_t length = slash != NULL ? (size_t)(slash - component) : strlen(component);
+    size_t prefixLength = strlen(prefix);
+    int n, i, hasMeta;
+    char* path;
+
+    n = compilePattern(component, length, ops, &hasMeta);
+    if (n < 0) { return; }
+
+    if (!hasMeta) {
+        /* Literal component, keep it and its / */
+        length += slash != NULL;
+        path = arenaAlloc(lineArena, prefixLength + length + 1);
+        memcpy(path, prefix, prefixLength);
+        memcpy(path + prefixLength, component, length);
+        path[prefixLength + length] = '\0';
+        if (slash != NULL && slash[1] != '\0') {
+            expandPattern(path, slash + 1, results, cache, lineArena);
+        } else if (lstat(path, &info) == 0) {
+            addResult(results, path, strlen(path), "", lineArena);
+        }
+        return;
+    }
+
+    listing = readListing(prefixLength == 0 ? "." : prefix, cache);
+    if (listing == NULL) { return; }
+    for (i = 0; i < listing->count; i++) {
+        char* name = listing->names[i];
+        if (name[0] == '.' && !(ops[0].type == GLOB_CHAR && ops[0].c == '.')) { continue; }    //Hidden names need a literal dot
+        if (!matchPattern(ops, n, name)) { continue; }
+
+        if (slash == NULL) {
+            addResult(results, prefix, prefixLength, name, lineArena);
+        } else {
+            /* Descend, names that are not directories fail to open in readListing */
+            size_t nameLength = strlen(name);
+            path = arenaAlloc(lineArena, prefixLength + nameLength + 2);
+            memcpy(path, prefix, prefixLength);
+            memcpy(path + prefixLength, name, nameLength);
+            path[prefixLength + nameLength] = '/';
+            path[prefixLength + nameLength + 1] = '\0';
+            if (slash[1] == '\0') {
+                if (lstat(path, &info) == 0) { addResult(results, path, strlen(path), "", lineArena); }    //Trailing / keeps directories only
+            } else {
+                expandPattern(path, slash + 1, results, cache, lineArena);
+            }
+        }
+    }
+}
+
+/*            comparePaths
+ * Description: qsort comparison for sorting matches bytewise.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at char*
+ */
+static int comparePaths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/*            expandGlobs
+ * Description: This function replaces every argument holding *, ? or [ by the sorted paths it matches and returns the new argument array,
+ *         allocated in lineArena. Arguments right after <, <<, <<<, > and >+ are left alone. count is updated, bytes grows by the length of the expansions.
+ * Parameters: char** args, int* count, size_t* bytes, struct arena* lineArena
+ * Returns: NULL terminated argument array
+ * Preconditions: args != NULL, count != NULL, bytes != NULL, lineArena != NULL
+ */
+char** expandGlobs(char** args, int* count, size_t* bytes, struct arena* lineArena) {
+    assert(args != NULL && count != NULL && bytes != NULL && lineArena != NULL);
+
+    struct globListing* cache = NULL;    //Listings read for this line
+    struct globListing* next;
+    struct globResults results = { NULL, 0, 0 };
+    char** expanded;
+    int total = 0;
+    int i, j, first;
+    int* counts = malloc((*count + 1) * sizeof(int));    //Matches of each argument, 0 keeps it literal
+    int* starts = malloc((*count + 1) * sizeof(int));    //First match of each argument in results
+    assert(counts != NULL && starts != NULL);
+
+    for (i = 0; i < *count; i++) {
+        counts[i] = 0;
+        starts[i] = results.count;
+        if (strpbrk(args[i], "*?[") == NULL || strchr(args[i], SUBST_MARK) != NULL) { continue; }    //Substitutions are expanded first
+        if (i > 0 && (strcmp(args[i - 1], "<") == 0 || strcmp(args[i - 1], "<<") == 0 || strcmp(args[i - 1], "<<<") == 0 || strcmp(args[i - 1], ">") == 0 || strcmp(args[i - 1], ">+") == 0)) { continue; }
+
+        first = results.count;
+        if (args[i][0] == '/') {
+            expandPattern("/", args[i] + 1, &results, &cache, lineArena);
+        } else {
+            expandPattern("", args[i], &results, &cache, lineArena);
+        }
+        counts[i] = results.count - first;
+        qsort(results.paths + first, counts[i], sizeof(char*), comparePaths);
+    }
+
+    for (i = 0; i < *count; i++) {
+        total += counts[i] > 0 ? counts[i] : 1;
+    }
+    expanded = arenaAlloc(lineArena, (total + 1) * sizeof(char*));
+    for (i = 0, j = 0; i < *count; i++) {
+        if (counts[i] == 0) {
+            expanded[j++] = args[i];    //No match, the pattern stays literal
+            continue;
+        }
+        *bytes -= strlen(args[i]) + 1;
+        for (first = starts[i]; first < starts[i] + counts[i]; first++) {
+            expanded[j++] = results.paths[first];
+            *bytes += strlen(results.paths[first]) + 1;
+        }
+    }
+    expanded[total] = NULL;
+    *count = total;
+
+    while (cache != NULL) {
+        next = cache->next;
+        free(cache->path);
+        free(cache->data);
+        free(cache->names);
+        free(cache);
+        cache = next;
+    }
+    free(results.paths);
+    free(counts);
+    free(starts);
+    return expanded;
+}
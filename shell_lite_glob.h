@@ -0,0 +1,23 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_glob.h
+* Description: This is the function declaration file for filename expansion in the shellLite shell. A word holding *, ? or a
+*              [...] class is replaced by the sorted paths it matches, a pattern that matches nothing stays as it is. Names
+*              starting with . only match a pattern component starting with a literal dot, . and .. are never matched.
+*              Directories are read with getdents64 into a large buffer and each listing is kept for the rest of the line,
+*              checked against the directory's mtime, so several patterns over one directory read it once.
+* Citations:
+*         1. getdents64(2) and glob(7) Linux manual pages, Assisted with reading directories and the pattern rules.
+*/
+#ifndef shell_lite_glob_h
+#define shell_lite_glob_h
+
+#include "shell_lite_builtins.h"
+
+#define GLOB_DENTS_SIZE 1048576    //Bytes requested from each getdents64 call
+#define GLOB_OPS_MAX 256           //Longest pattern component, in compiled operations
+
+char** expandGlobs(char**, int*, size_t*, struct arena*);    //Replaces every pattern in args by its matches
+
+#endif /* shell_lite_glob_h */
@@ -0,0 +1,290 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_hash.c
+* Description: This is the function implementation file for the command path cache of the shellLite shell. The first miss for
+*              a PATH value scans every PATH directory once with opendir and records the first match for every name, later
+*              lookups are a single hash probe.
+* Citations:
+*         1. Kernighan, Brian and Ritchie, Dennis "The C Programming Language" 6.6 Table Lookup, Assisted with the chained hash table.
+*/
+#include "shell_lite_hash.h"
+
+static struct commandEntry** buckets = NULL;    //Chained hash table of commands
+static int bucketCount = 0;                     //Number of buckets, power of two
+static int entryCount = 0;                      //Number of entries in the table
+static char* cachedPath = NULL;                 //Copy of PATH the table was built from
+static int prefilled = 0;                       //1 once PATH directories have been scanned
+static long hashHits = 0;                       //Lookups answered from the table
+static long hashMisses = 0;                     //Lookups that needed the file system
+
+/*            hashName
+ * Description: FNV-1a hash of a command name.
+ * Parameters: char* name
+ * Returns: unsigned hash value
+ * Preconditions: name != NULL
+ */
+static unsigned hashName(char* name) {
+    unsigned h = 2166136261u;
+    while (*name) {
+        h ^= (unsigned char)*name++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*            findEntry
+ * Description: Returns the entry for name or NULL if it is not cached.
+ * Parameters: char* name
+ * Returns: struct commandEntry* or NULL
+ * Preconditions: name != NULL
+ */
+static struct commandEntry* findEntry(char* name) {
+    struct commandEntry* e;
+    if (bucketCount == 0) { return NULL; }
+
+    for (e = buckets[hashName(name) & (bucketCount - 1)]; e != NULL; e = e->next) {
+        if (strcmp(e->name, name) == 0) { return e; }
+    }
+    return NULL;
+}
+
+/*            insertEntry
+ * Description: Adds name -> dir/name to the table unless name is already cached, the table doubles once it is 3/4 full.
+ * Parameters: char* name, char* dir, int verified
+ * Returns: struct commandEntry* for name
+ * Preconditions: name != NULL, dir != NULL
+ */
+static struct commandEntry* insertEntry(char* name, char* dir, int verified) {
+    int i;
+    struct commandEntry* e = findEntry(name);
+    if (e != NULL) { return e; }    //Earlier PATH directories win
+
+    if (entryCount >= bucketCount - bucketCount / 4) {
+        /* Grow and rehash */
+        int newCount = bucketCount ? bucketCount * 2 : HASH_START_BUCKETS;
+        struct commandEntry** newBuckets = calloc(newCount, sizeof(struct commandEntry*));
+        assert(newBuckets != NULL);
+        for (i = 0; i < bucketCount; i++) {
+            while (buckets[i] != NULL) {
+                e = buckets[i];
+                buckets[i] = e->next;
+                e->next = newBuckets[hashName(e->name) & (newCount - 1)];
+                newBuckets[hashName(e->name) & (newCount - 1)] = e;
+            }
+        }
+        free(buckets);
+        buckets = newBuckets;
+        bucketCount = newCount;
+    }
+
+    e = malloc(sizeof(struct commandEntry));
+    assert(e != NULL);
+    e->name = strdup(name);
+    e->path = malloc(strlen(dir) + strlen(name) + 2);
+    assert(e->name != NULL && e->path != NULL);
+    sprintf(e->path, "%s/%s", dir, name);
+    e->hits = 0;
+    e->verified = verified;
+    e->next = buckets[hashName(name) & (bucketCount - 1)];
+    buckets[hashName(name) & (bucketCount - 1)] = e;
+    entryCount++;
+    return e;
+}
+
+/*            isExecutable
+ * Description: Returns 1 if path is a regular file the shell may execute.
+ * Parameters: char* path
+ * Returns: 1 or 0
+ * Preconditions: path != NULL
+ */
+static int isExecutable(char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 && S_ISREG(info.st_mode) && access(path, X_OK) == 0;
+}
+
+/*            prefillCache
+ * Description: Scans every PATH directory with opendir once and records the first directory holding each name. Entries are unverified
+ *         until their first lookup, so only commands actually run pay for a stat.
+ * Parameters: char* path (copy of PATH, modified)
+ * Returns: void
+ * Preconditions: path != NULL
+ */
+static void prefillCache(char* path) {
+    char* dir;
+    char* save = NULL;
+    DIR* d;
+    struct dirent* ent;
+
+    for (dir = strtok_r(path, ":", &save); dir != NULL; dir = strtok_r(NULL, ":", &save)) {
+        if (dir[0] != '/') { continue; }    //Relative PATH entries depend on cwd, never cache them
+        d = opendir(dir);
+        if (d == NULL) { continue; }
+        while ((ent = readdir(d)) != NULL) {
+            if (ent->d_name[0] == '.') { continue; }
+            insertEntry(ent->d_name, dir, 0);
+        }
+        closedir(d);
+    }
+    prefilled = 1;
+}
+
+/*            searchPath
+ * Description: Walks PATH for name the way execvp does, used when the prefill scan did not yield an executable.
+ * Parameters: char* name
+ * Returns: struct commandEntry* or NULL if name is not on PATH
+ * Preconditions: name != NULL
+ */
+static struct commandEntry* searchPath(char* name) {
+    char* path = strdup(cachedPath);
+    char* dir;
+    char* save = NULL;
+    char* candidate;
+    struct commandEntry* e = NULL;
+    assert(path != NULL);
+
+    for (dir = strtok_r(path, ":", &save); dir != NULL && e == NULL; dir = strtok_r(NULL, ":", &save)) {
+        if (dir[0] != '/') { continue; }
+        candidate = malloc(strlen(dir) + strlen(name) + 2);
+        assert(candidate != NULL);
+        sprintf(candidate, "%s/%s", dir, name);
+        if (isExecutable(candidate)) {
+            forgetCommand(name);    //Replace a stale entry from the prefill scan
+            e = insertEntry(name, dir, 1);
+        }
+        free(candidate);
+    }
+    free(path);
+    return e;
+}
+
+/*            lookupCommand
+ * Description: Returns the absolute path to execute for name. Names containing / are returned as is. The table is cleared first if PATH
+ *         changed since it was built. The returned string belongs to the cache.
+ * Parameters: char* name
+ * Returns: path or NULL if name is not found on PATH
+ * Preconditions: name != NULL
+ */
+char* lookupCommand(char* name) {
+    assert(name != NULL);
+
+    char* path = getenv("PATH");
+    struct commandEntry* e;
+
+    if (strchr(name, '/') != NULL) { return name; }
+    if (path == NULL) { path = "/bin:/usr/bin"; }
+
+    /* Invalidate if PATH changed */
+    if (cachedPath == NULL || strcmp(cachedPath, path) != 0) {
+        clearCommandCache();
+        cachedPath = strdup(path);
+        assert(cachedPath != NULL);
+    }
+
+    e = findEntry(name);
+    if (e != NULL && e->verified) {
+        hashHits++;
+        e->hits++;
+        return e->path;
+    }
+
+    hashMisses++;
+    if (e == NULL && !prefilled) {
+        char* copy = strdup(cachedPath);
+        assert(copy != NULL);
+        prefillCache(copy);
+        free(copy);
+        e = findEntry(name);
+    }
+
+    if (e != NULL && isExecutable(e->path)) {
+        e->verified = 1;
+    } else {
+        e = searchPath(name);
+    }
+    if (e == NULL) { return NULL; }
+
+    e->hits++;
+    return e->path;
+}
+
+/*            forgetCommand
+ * Description: Removes name from the cache, called when exec of a cached path fails with ENOENT.
+ * Parameters: char* name
+ * Returns: void
+ * Preconditions: name != NULL
+ */
+void forgetCommand(char* name) {
+    assert(name != NULL);
+
+    struct commandEntry** link;
+    struct commandEntry* e;
+    if (bucketCount == 0) { return; }
+
+    for (link = &buckets[hashName(name) & (bucketCount - 1)]; *link != NULL; link = &(*link)->next) {
+        if (strcmp((*link)->name, name) == 0) {
+            e = *link;
+            *link = e->next;
+            free(e->name); free(e->path); free(e);
+            entryCount--;
+            return;
+        }
+    }
+}
+
+/*            clearCommandCache
+ * Description: Frees every entry in the cache, the next miss scans PATH again.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void clearCommandCache(void) {
+    int i;
+    struct commandEntry* e;
+
+    for (i = 0; i < bucketCount; i++) {
+        while (buckets[i] != NULL) {
+            e = buckets[i];
+            buckets[i] = e->next;
+            free(e->name); free(e->path); free(e);
+        }
+    }
+    entryCount = 0;
+    prefilled = 0;
+    free(cachedPath);
+    cachedPath = NULL;
+}
+
+/*            hashCommand
+ * Description: The hash builtin. With no arguments lists every command launched from the cache and the hit/miss counters, -r clears the
+ *         cache, any other arguments are looked up and added.
+ * Parameters: char** args, int count
+ * Returns: void
+ * Preconditions: args != NULL, count >= 1
+ */
+void hashCommand(char** args, int count) {
+    assert(args != NULL && count >= 1);
+
+    int i;
+    struct commandEntry* e;
+
+    if (count == 1) {
+        printf("hits\tcommand\n");
+        for (i = 0; i < bucketCount; i++) {
+            for (e = buckets[i]; e != NULL; e = e->next) {
+                if (e->hits > 0) { printf("%4d\t%s\n", e->hits, e->path); }
+            }
+        }
+        printf("hash: %ld hits, %ld misses\n", hashHits, hashMisses);
+    } else if (strcmp(args[1], "-r") == 0) {
+        clearCommandCache();
+        hashHits = 0;
+        hashMisses = 0;
+    } else {
+        for (i = 1; i < count; i++) {
+            if (lookupCommand(args[i]) == NULL) {
+                fprintf(stderr, "hash: %s: not found\n", args[i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_hash.h
+* Description: This is the function declaration file for the command path cache of the shellLite shell. Non-builtin commands
+*              are resolved to an absolute path once and remembered, so launching a command no longer walks every PATH
+*              directory. The cache is cleared whenever PATH changes, and a single entry is dropped when exec reports ENOENT.
+*              The hash builtin lists the cache and its hit/miss counters, hash -r clears it.
+* Citations:
+*         1. Kernighan, Brian and Ritchie, Dennis "The C Programming Language" 6.6 Table Lookup, Assisted with the chained hash table.
+*/
+#ifndef shell_lite_hash_h
+#define shell_lite_hash_h
+
+#include "shell_lite_builtins.h"
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define HASH_START_BUCKETS 256    //Initial bucket count, always a power of two
+
+                            /* Struct for one cached command */
+struct commandEntry {
+    char* name;                  //Command as typed
+    char* path;                  //Absolute path found on PATH
+    int hits;                    //Number of launches resolved from this entry
+    int verified;                //1 once path is known to be an executable file
+    struct commandEntry* next;   //Next entry in the same bucket
+};
+
+char* lookupCommand(char*);    //Returns the absolute path for a command, or NULL if it is not on PATH
+
+void forgetCommand(char*);    //Drops a command from the cache
+
+void clearCommandCache(void);    //Drops every command from the cache
+
+void hashCommand(char**, int);    //Runs the hash builtin
+
+#endif /* shell_lite_hash_h */
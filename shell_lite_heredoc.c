@@ -0,0 +1,109 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_heredoc.c
+* Description: This is the function implementation file for here-documents and here-strings in the shellLite shell. Bodies
+*              are read from the shell's own line reader right after the command line and kept in the line arena, the text
+*              reaches the command through a memfd sealed against every change so it reads exactly what the shell wrote.
+* Citations:
+*         1. memfd_create(2) and fcntl(2) File Sealing Linux manual pages, Assisted with staging the text.
+*/
+#include "shell_lite_heredoc.h"
+
+#define HEREDOC_START_SIZE 1024    //Initial size of a body, doubled as lines are added
+
+/*            readHereDocuments
+ * Description: This function reads the body of every << here-document on the line, in order, from reader. A body is the lines up to one that is
+ *         exactly the delimiter word, each ending with a newline, with $$ expanded like variableExpansion does. The delimiter word in args is
+ *         replaced by the body. End of input before the delimiter ends the body with a warning.
+ * Parameters: char** args, int count, struct lineReader* reader, char* pid, int interactive, struct arena* lineArena
+ * Returns: void
+ * Preconditions: args came from parseBuffer, reader != NULL, pid != NULL, lineArena != NULL
+ */
+void readHereDocuments(char** args, int count, struct lineReader* reader, char* pid, int interactive, struct arena* lineArena) {
+    assert(args != NULL && reader != NULL && pid != NULL && lineArena != NULL);
+
+    size_t capacity, used, length;
+    ssize_t numRead;
+    char* body;
+    char* line;
+    int prompted;
+    int i;
+
+    for (i = 0; i + 1 < count; i++) {
+        if (strcmp(args[i], "<<") != 0) { continue; }
+
+        capacity = HEREDOC_START_SIZE;
+        used = 0;
+        body = arenaAlloc(lineArena, capacity);    //Newest allocation, grows in place
+        prompted = 0;
+
+        while (1) {
+            numRead = takeLine(reader, &line);
+            if (numRead == 0) {
+                if (interactive && !prompted) {
+                    write(STDOUT_FILENO, HEREDOC_PROMPT, strlen(HEREDOC_PROMPT));
+                    prompted = 1;
+                }
+                numRead = readLine(reader, &line);
+                if (numRead == -1 && errno == EINTR) { continue; }
+            }
+            if (numRead <= 0) {
+                fprintf(stderr, "Warning, here-document ended by end of input (wanted %s)\n", args[i + 1]);
+                break;
+            }
+            prompted = 0;
+            if (strcmp(line, args[i + 1]) == 0) { break; }    //Delimiter line
+
+            length = strlen(line);
+            if (used + length + 2 > capacity) {
+                size_t grown = capacity * 2 > used + length + 2 ? capacity * 2 : used + length + 2;
+                body = arenaGrow(lineArena, body, used, grown);
+                capacity = grown;
+            }
+            memcpy(body + used, line, length);
+            used += length;
+            body[used++] = '\n';
+        }
+        body[used] = '\0';
+
+        args[i + 1] = variableExpansion(body, pid, lineArena);
+        i++;    //Skip the body
+    }
+}
+
+/*            stageHereText
+ * Description: This function writes text, and a newline if newline is set, to a memfd and seals it against writes, shrinking and growing so the
+ *         command cannot change what it reads. The descriptor is O_CLOEXEC, only its dup2 copy reaches the command.
+ * Parameters: char* text, int newline
+ * Returns: memfd positioned at the start of the text, -1 on error
+ * Preconditions: text != NULL
+ */
+int stageHereText(char* text, int newline) {
+    assert(text != NULL);
+
+    size_t length = strlen(text);
+    ssize_t written;
+    int fd = memfd_create("shellLite here-document", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+    if (fd == -1) { perror("memfd_create() error\n"); return -1; }
+
+    while (length > 0) {
+        written = write(fd, text, length);
+        if (written == -1) {
+            if (errno == EINTR) { continue; }
+            goto failed;
+        }
+        text += written;
+        length -= written;
+    }
+    if (newline && write(fd, "\n", 1) != 1) { goto failed; }
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1) { goto failed; }
+    if (lseek(fd, 0, SEEK_SET) == -1) { goto failed; }
+    return fd;
+
+failed:
+    perror("here-document error\n");
+    close(fd);
+    return -1;
+}
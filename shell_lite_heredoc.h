@@ -0,0 +1,26 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_heredoc.h
+* Description: This is the function declaration file for here-documents and here-strings in the shellLite shell.
+*                  command <<WORD    stdin is the following input lines up to a line that is exactly WORD
+*                  command <<< word  stdin is word and a newline
+*              $$ is expanded in both. The text is written to a sealed memfd_create file that becomes the command's stdin,
+*              nothing touches the filesystem and there is no temp file to remove.
+* Citations:
+*         1. memfd_create(2) and fcntl(2) File Sealing Linux manual pages, Assisted with staging the text.
+*/
+#ifndef shell_lite_heredoc_h
+#define shell_lite_heredoc_h
+
+#include "shell_lite_builtins.h"
+#include "shell_lite_input.h"
+#include <sys/mman.h>
+
+#define HEREDOC_PROMPT "> "    //Shown before each body line at the terminal
+
+void readHereDocuments(char**, int, struct lineReader*, char*, int, struct arena*);    //Replaces each << delimiter with the body read from the input
+
+int stageHereText(char*, int);    //Writes the text to a sealed memfd, returns it positioned at the start
+
+#endif /* shell_lite_heredoc_h */
@@ -0,0 +1,423 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_history.c
+* Description: This is the function implementation file for the command history of the shellLite shell. Opening the history is
+*              open, fstat and mmap, nothing is read. The first lookup finds the line starts with memchr into an array of 32 bit
+*              offsets, and the first prefix lookup sorts those offsets by text, so a prefix is a binary search. Lines added
+*              after the sort, by this shell or by another one, are a short tail searched from the end. Substring search runs
+*              memmem over the mapping. The mapping is grown with mremap when the file has grown since it was mapped, and
+*              dropped and rebuilt when the file was truncated, since touching pages past the end of the file raises SIGBUS.
+* Citations:
+*         1. Ramey, Chet "GNU History Library" manual, Assisted with the event designators.
+*         2. mmap(2), mremap(2) and open(2) O_APPEND Linux manual pages, Assisted with mapping and sharing the file.
+*/
+#include "shell_lite_history.h"
+#include <stdint.h>
+
+static int historyFd = -1;            //History file, O_APPEND
+static char* map = NULL;              //Mapping of the file, NULL while it is empty
+static size_t mapLength = 0;          //Bytes mapped
+static uint32_t* starts = NULL;       //Offset of every complete line in map
+static size_t entryCount = 0;         //Lines in starts
+static size_t startsCapacity = 0;     //Size of starts
+static size_t scanned = 0;            //Bytes of map already split into lines
+static uint32_t* sorted = NULL;       //Offsets of the first sortedCount lines, sorted by text
+static size_t sortedCount = 0;        //Lines covered by sorted
+
+/*            lineLength
+ * Description: Returns the length of the history line at offset, without its newline.
+ * Parameters: uint32_t offset
+ * Returns: length in bytes
+ * Preconditions: offset is a line start in map
+ */
+static size_t lineLength(uint32_t offset) {
+    char* newline = memchr(map + offset, '\n', mapLength - offset);
+    return newline != NULL ? (size_t)(newline - (map + offset)) : mapLength - offset;
+}
+
+/*            refreshHistory
+ * Description: Maps whatever was appended to the file since the last call, then splits the new complete lines into starts. A file shorter
+ *         than the mapping was truncated, the mapping and the indexes are dropped and the file is mapped and scanned from the start.
+ * Parameters: void
+ * Returns: 0 on success, -1 if the history is unavailable
+ * Preconditions: N/A
+ */
+static int refreshHistory(void) {
+    struct stat info;
+    char* next;
+    char* end;
+    void* grown;
+
+    if (historyFd == -1 || fstat(historyFd, &info) == -1) { return -1; }
+    if ((size_t)info.st_size > UINT32_MAX) {
+        fprintf(stderr, "history: file is larger than 4 GB\n");
+        return -1;
+    }
+
+    if ((size_t)info.st_size < mapLength) {
+        munmap(map, mapLength);
+        map = NULL;
+        mapLength = 0;
+        entryCount = 0;
+        scanned = 0;
+        free(sorted);
+        sorted = NULL;
+        sortedCount = 0;
+    }
+    if ((size_t)info.st_size > mapLength) {
+        if (map == NULL) {
+            grown = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, historyFd, 0);
+        } else {
+            grown = mremap(map, mapLength, info.st_size, MREMAP_MAYMOVE);
+        }
+        if (grown == MAP_FAILED) { perror("history mmap() error\n"); return -1; }
+        map = grown;
+        mapLength = info.st_size;
+    }
+
+    /* Split new complete lines, a record being written by another shell is picked up next time */
+    end = map + mapLength;
+    while (scanned < mapLength && (next = memchr(map + scanned, '\n', end - (map + scanned))) != NULL) {
+        if (entryCount == startsCapacity) {
+            startsCapacity = startsCapacity == 0 ? 4096 : startsCapacity * 2;
+            starts = realloc(starts, startsCapacity * sizeof(uint32_t));
+            assert(starts != NULL);
+        }
+        starts[entryCount++] = scanned;
+        scanned = next - map + 1;
+    }
+    return 0;
+}
+
+/*            compareLines
+ * Description: qsort comparison of two history lines by text, then by position so the sort is stable.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at line offsets in map
+ */
+static int compareLines(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    unsigned char* s = (unsigned char*)map + x;
+    unsigned char* t = (unsigned char*)map + y;
+
+    while (*s == *t && *s != '\n') { s++; t++; }
+    if (*s != *t) { return (*s == '\n' ? -1 : *t == '\n' ? 1 : *s - *t); }    //A line sorts before the lines it is a prefix of
+    return x < y ? -1 : x > y;
+}
+
+/*            compareOffsets
+ * Description: qsort comparison of two line offsets, file order.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at uint32_t
+ */
+static int compareOffsets(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+/*            startsWith
+ * Description: Compares the start of the history line at offset with prefix.
+ * Parameters: uint32_t offset, char* prefix, size_t length
+ * Returns: < 0 if the line sorts before prefix, 0 if it starts with prefix, > 0 if it sorts after
+ * Preconditions: offset is a line start in map
+ */
+static int startsWith(uint32_t offset, char* prefix, size_t length) {
+    unsigned char* s = (unsigned char*)map + offset;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        if (s[i] == '\n' || s[i] < (unsigned char)prefix[i]) { return -1; }
+        if (s[i] > (unsigned char)prefix[i]) { return 1; }
+    }
+    return 0;
+}
+
+/*            sortHistory
+ * Description: Builds the sorted index on first use, and rebuilds it once the lines added after it outnumber the lines it covers.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: refreshHistory succeeded
+ */
+static void sortHistory(void) {
+    if (sorted != NULL && sortedCount * 2 >= entryCount) { return; }
+
+    free(sorted);
+    sorted = malloc((entryCount + 1) * sizeof(uint32_t));
+    assert(sorted != NULL);
+    memcpy(sorted, starts, entryCount * sizeof(uint32_t));
+    sortedCount = entryCount;
+    qsort(sorted, sortedCount, sizeof(uint32_t), compareLines);
+}
+
+/*            findPrefix
+ * Description: Finds the most recent line starting with prefix. The last HISTORY_SCAN lines and any lines after the sorted index are checked
+ *         from the end, most recalls end there without building the index. Otherwise the index gives the range of matching lines by binary search.
+ * Parameters: char* prefix, size_t length
+ * Returns: offset of the line, -1 if none matches
+ * Preconditions: refreshHistory succeeded
+ */
+static long long findPrefix(char* prefix, size_t length) {
+    size_t low, high, middle, i;
+    size_t recent = entryCount > HISTORY_SCAN ? entryCount - HISTORY_SCAN : 0;    //Lines checked without the index
+    uint32_t best;
+
+    for (i = entryCount; i > recent; i--) {
+        if (startsWith(starts[i - 1], prefix, length) == 0) { return starts[i - 1]; }
+    }
+
+    sortHistory();
+
+    for (i = recent; i > sortedCount; i--) {
+        if (startsWith(starts[i - 1], prefix, length) == 0) { return starts[i - 1]; }
+    }
+
+    /* First line not sorting before prefix */
+    low = 0;
+    high = sortedCount;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (startsWith(sorted[middle], prefix, length) < 0) { low = middle + 1; } else { high = middle; }
+    }
+    if (low == sortedCount || startsWith(sorted[low], prefix, length) != 0) { return -1; }
+
+    /* The largest offset among the matches is the most recent */
+    best = sorted[low];
+    for (i = low + 1; i < sortedCount && startsWith(sorted[i], prefix, length) == 0; i++) {
+        if (sorted[i] > best) { best = sorted[i]; }
+    }
+    return best;
+}
+
+/*            entryNumber
+ * Description: Returns the 1 based number of the line starting at or containing offset.
+ * Parameters: size_t offset
+ * Returns: line number
+ * Preconditions: entryCount > 0, offset < scanned
+ */
+static size_t entryNumber(size_t offset) {
+    size_t low = 0, high = entryCount, middle;
+
+    while (high - low > 1) {
+        middle = low + (high - low) / 2;
+        if (starts[middle] <= offset) { low = middle; } else { high = middle; }
+    }
+    return low + 1;
+}
+
+/*            printEntry
+ * Description: Prints history line number n, n is 1 based.
+ * Parameters: size_t n
+ * Returns: void
+ * Preconditions: 1 <= n <= entryCount
+ */
+static void printEntry(size_t n) {
+    printf("%6zu  %.*s\n", n, (int)lineLength(starts[n - 1]), map + starts[n - 1]);
+}
+
+/*            initHistory
+ * Description: This function opens the history file, creating it, and maps it. Without SHELLLITE_HISTORY only interactive shells keep history.
+ * Parameters: int interactive
+ * Returns: void
+ * Preconditions: Called once
+ */
+void initHistory(int interactive) {
+    char* path = getenv("SHELLLITE_HISTORY");
+    char* home = getenv("HOME");
+    char defaultPath[PATH_MAX];
+
+    if (path == NULL || path[0] == '\0') {
+        if (!interactive || home == NULL) { return; }
+        snprintf(defaultPath, sizeof(defaultPath), "%s/.shellLite_history", home);
+        path = defaultPath;
+    }
+
+    historyFd = open(path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (historyFd == -1) { perror("history open() error\n"); return; }
+
+    /* Map only, lines are split on the first lookup */
+    struct stat info;
+    if (fstat(historyFd, &info) == 0 && info.st_size > 0 && (size_t)info.st_size <= UINT32_MAX) {
+        map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, historyFd, 0);
+        if (map == MAP_FAILED) { map = NULL; } else { mapLength = info.st_size; }
+    }
+}
+
+/*            freeHistory
+ * Description: This function unmaps and closes the history file and frees the index.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void freeHistory(void) {
+    if (map != NULL) { munmap(map, mapLength); }
+    if (historyFd != -1) { close(historyFd); }
+    free(starts);
+    free(sorted);
+    map = NULL;
+    historyFd = -1;
+    starts = sorted = NULL;
+    mapLength = entryCount = startsCapacity = scanned = sortedCount = 0;
+}
+
+/*            addHistory
+ * Description: This function appends line to the history file as one write of the line and its newline, so it lands whole even when other shells
+ *         append at the same time. Blank lines are not kept.
+ * Parameters: char* line, size_t length
+ * Returns: void
+ * Preconditions: line != NULL
+ */
+void addHistory(char* line, size_t length) {
+    assert(line != NULL);
+
+    char small[1024];
+    char* record = small;
+    ssize_t written;
+
+    if (historyFd == -1) { return; }
+    length = strnlen(line, length);
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == ' ' || line[length - 1] == '\t')) { length--; }
+    if (length == 0 || memchr(line, '\n', length) != NULL) { return; }    //One record per line
+
+    if (length + 1 > sizeof(small)) {
+        record = malloc(length + 1);
+        assert(record != NULL);
+    }
+    memcpy(record, line, length);
+    record[length] = '\n';
+    do {
+        written = write(historyFd, record, length + 1);
+    } while (written == -1 && errno == EINTR);
+    if (written == -1) { perror("history write() error\n"); }
+    if (record != small) { free(record); }
+}
+
+/*            recallHistory
+ * Description: This function replaces a line starting with ! by the history line it names: !! the last one, !N line N, !prefix the most recent
+ *         line starting with prefix. The recalled command is echoed like in bash. *line points into the mapping afterwards and stays valid until
+ *         the next history lookup.
+ * Parameters: char** line, size_t length
+ * Returns: length of the recalled command, -1 if no line matches
+ * Preconditions: line != NULL, (*line)[0] == '!'
+ */
+ssize_t recallHistory(char** line, size_t length) {
+    assert(line != NULL && *line != NULL);
+
+    char* event = *line + 1;
+    char* end;
+    long long offset = -1;
+    unsigned long number;
+
+    length = strnlen(*line, length);
+    while (length > 1 && ((*line)[length - 1] == ' ' || (*line)[length - 1] == '\t' || (*line)[length - 1] == '\n')) { length--; }
+    if (refreshHistory() == -1) {
+        fprintf(stderr, "history: not enabled\n");
+        return -1;
+    }
+
+    if (length == 2 && event[0] == '!') {
+        if (entryCount > 0) { offset = starts[entryCount - 1]; }
+    } else if (event[0] >= '0' && event[0] <= '9') {
+        number = strtoul(event, &end, 10);
+        if (end == *line + length && number >= 1 && number <= entryCount) { offset = starts[number - 1]; }
+    } else if (length > 1) {
+        offset = findPrefix(event, length - 1);
+    }
+
+    if (offset == -1) {
+        fprintf(stderr, "history: %.*s: event not found\n", (int)length, *line);
+        return -1;
+    }
+    *line = map + offset;
+    length = lineLength(offset);
+    printf("%.*s\n", (int)length, *line);
+    return length;
+}
+
+/*            historyCommand
+ * Description: The history builtin. history [N] prints the last N commands, history -p prefix the commands starting with prefix in file order, history
+ *         -s text the commands containing text. The words after -p and -s are joined by single spaces.
+ * Parameters: char** args, int count
+ * Returns: void
+ * Preconditions: args != NULL, count >= 1
+ */
+void historyCommand(char** args, int count) {
+    assert(args != NULL && count >= 1);
+
+    size_t show = HISTORY_SHOW;
+    size_t i, low, high, middle, length, number;
+    uint32_t* matches;
+    char* text = NULL;    //Search text
+    char* found;
+    char* from;
+    char* end;
+
+    if (refreshHistory() == -1) {
+        fprintf(stderr, "history: not enabled\n");
+        return;
+    }
+
+    if (count >= 3 && (strcmp(args[1], "-s") == 0 || strcmp(args[1], "-p") == 0)) {
+        /* The rest of the line is the text, the lexer split it on spaces */
+        for (i = 2, length = 0; (int)i < count; i++) { length += strlen(args[i]) + 1; }
+        text = malloc(length);
+        assert(text != NULL);
+        for (i = 2, length = 0; (int)i < count; i++) {
+            if (i > 2) { text[length++] = ' '; }
+            strcpy(text + length, args[i]);
+            length += strlen(args[i]);
+        }
+    }
+
+    if (count >= 3 && strcmp(args[1], "-s") == 0) {
+        /* memmem over the mapping, every hit prints its line once */
+        from = map;
+        end = map + scanned;
+        while (from < end && (found = memmem(from, end - from, text, length)) != NULL) {
+            number = entryNumber(found - map);
+            if (memchr(found, '\n', length) == NULL) { printEntry(number); }    //Text inside one line
+            from = map + (number < entryCount ? starts[number] : scanned);
+        }
+    } else if (count >= 3 && strcmp(args[1], "-p") == 0) {
+        sortHistory();
+        low = 0;
+        high = sortedCount;
+        while (low < high) {
+            middle = low + (high - low) / 2;
+            if (startsWith(sorted[middle], text, length) < 0) { low = middle + 1; } else { high = middle; }
+        }
+        for (high = low; high < sortedCount && startsWith(sorted[high], text, length) == 0; high++) { }
+
+        /* Matches in file order: the sorted range, then the tail */
+        matches = malloc((high - low + entryCount - sortedCount + 1) * sizeof(uint32_t));
+        assert(matches != NULL);
+        memcpy(matches, sorted + low, (high - low) * sizeof(uint32_t));
+        number = high - low;
+        for (i = sortedCount; i < entryCount; i++) {
+            if (startsWith(starts[i], text, length) == 0) { matches[number++] = starts[i]; }
+        }
+        qsort(matches, number, sizeof(uint32_t), compareOffsets);
+        for (i = 0; i < number; i++) {
+            printEntry(entryNumber(matches[i]));
+        }
+        free(matches);
+    } else if (count <= 2) {
+        if (count == 2) {
+            errno = 0;
+            show = strtoul(args[1], &end, 10);
+            if (args[1][0] < '0' || args[1][0] > '9' || *end != '\0' || errno != 0) {    //strtoul takes a sign and leading spaces
+                fprintf(stderr, "Usage: history [N] | history -p prefix | history -s text\n");
+                return;
+            }
+        }
+        for (i = entryCount > show ? entryCount - show : 0; i < entryCount; i++) {
+            printEntry(i + 1);
+        }
+    } else {
+        fprintf(stderr, "Usage: history [N] | history -p prefix | history -s text\n");
+    }
+    free(text);
+}
@@ -0,0 +1,39 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_history.h
+* Description: This is the function declaration file for the command history of the shellLite shell. History is one command per
+*              line in SHELLLITE_HISTORY, $HOME/.shellLite_history by default. The file is memory mapped at startup and only
+*              appended to, every line is one O_APPEND write so shells sharing the file never interleave records:
+*                  history [N]            prints the last N commands, 20 by default, numbered from the start of the file
+*                  history -p prefix      prints every command starting with prefix
+*                  history -s text        prints every command containing text
+*                  !!  !N  !prefix        at the start of a line, replaced by the last command, command N or the most recent
+*                                         command starting with prefix
+*              Interactive shells keep history, scripts only when SHELLLITE_HISTORY is set.
+* Citations:
+*         1. Ramey, Chet "GNU History Library" manual, Assisted with the event designators.
+*/
+#ifndef shell_lite_history_h
+#define shell_lite_history_h
+
+#include "shell_lite_builtins.h"
+#include <errno.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define HISTORY_SHOW 20      //Commands printed by history without a count
+#define HISTORY_SCAN 4096    //Most recent commands searched for !prefix before the sorted index is used
+
+void initHistory(int);    //Opens and maps the history file
+
+void freeHistory(void);    //Unmaps and closes the history file
+
+void addHistory(char*, size_t);    //Appends a command line as one record
+
+ssize_t recallHistory(char**, size_t);    //Replaces a !event line by the command it names
+
+void historyCommand(char**, int);    //The history builtin
+
+#endif /* shell_lite_history_h */
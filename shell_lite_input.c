@@ -0,0 +1,122 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_input.c
+* Description: This is the function implementation file for the line reader of the shellLite shell. Lines are returned as
+*              pointers into the block buffer with the newline replaced by a null terminator, nothing is copied.
+* Citations:
+*         1. Stevens, W. Richard "Advanced Programming in the UNIX Environment" 3.9 I/O Efficiency, Assisted with buffer sizing.
+*/
+#include "shell_lite_input.h"
+
+/*            initLineReader
+ * Description: This function sets up reader to read lines from fd.
+ * Parameters: struct lineReader* reader, int fd
+ * Returns: void
+ * Preconditions: reader != NULL, fd >= 0
+ */
+void initLineReader(struct lineReader* reader, int fd) {
+    assert(reader != NULL && fd >= 0);
+
+    reader->fd = fd;
+    reader->capacity = INPUT_BLOCK_SIZE;
+    reader->buffer = malloc(reader->capacity + 1);    //One extra byte so the last line can always be null terminated
+    assert(reader->buffer != NULL);
+    reader->start = 0;
+    reader->end = 0;
+    reader->eof = 0;
+}
+
+/*            takeLine
+ * Description: This function returns the next complete line already in the buffer through line, without reading. The newline is replaced by a
+ *         null terminator and the returned length counts it, so an empty line has length 1. The line stays valid until the next fill. After end of
+ *         input the final line without a newline is returned as well.
+ * Parameters: struct lineReader* reader, char** line
+ * Returns: length of the line, 0 if no complete line is buffered
+ * Preconditions: reader != NULL, line != NULL
+ */
+ssize_t takeLine(struct lineReader* reader, char** line) {
+    assert(reader != NULL && line != NULL);
+
+    char* newline = memchr(reader->buffer + reader->start, '\n', reader->end - reader->start);
+    size_t length;
+
+    if (newline != NULL) {
+        *newline = '\0';
+        *line = reader->buffer + reader->start;
+        length = newline - *line + 1;
+        reader->start += length;
+        return length;
+    }
+
+    if (reader->eof && reader->start < reader->end) {
+        reader->buffer[reader->end] = '\0';    //Last line without a newline
+        *line = reader->buffer + reader->start;
+        length = reader->end - reader->start;
+        reader->start = reader->end;
+        return length;
+    }
+    return 0;
+}
+
+/*            fillLineReader
+ * Description: This function makes one read(2) into the buffer, so it never blocks when the descriptor was reported readable. The partial line
+ *         is moved to the front first and lines longer than the buffer grow it by doubling.
+ * Parameters: struct lineReader* reader
+ * Returns: bytes read, 0 at end of input, -1 if read was interrupted or failed
+ * Preconditions: reader != NULL
+ */
+ssize_t fillLineReader(struct lineReader* reader) {
+    assert(reader != NULL);
+
+    ssize_t numRead;
+
+    /* Move the partial line to the front, grow if it fills the whole buffer */
+    if (reader->start > 0) {
+        memmove(reader->buffer, reader->buffer + reader->start, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+    }
+    if (reader->end == reader->capacity) {
+        reader->capacity *= 2;
+        reader->buffer = realloc(reader->buffer, reader->capacity + 1);
+        assert(reader->buffer != NULL);
+    }
+
+    numRead = read(reader->fd, reader->buffer + reader->end, reader->capacity - reader->end);
+    if (numRead == -1) { return -1; }    //Interrupted by a signal, caller decides whether to retry
+    if (numRead == 0) { reader->eof = 1; }
+    reader->end += numRead;
+    return numRead;
+}
+
+/*            readLine
+ * Description: This function returns the next line of input through line, reading until a whole line is buffered. See takeLine for the format.
+ * Parameters: struct lineReader* reader, char** line
+ * Returns: length of the line, 0 at end of input, -1 if read was interrupted or failed
+ * Preconditions: reader != NULL, line != NULL
+ */
+ssize_t readLine(struct lineReader* reader, char** line) {
+    assert(reader != NULL && line != NULL);
+
+    ssize_t length;
+
+    while ((length = takeLine(reader, line)) == 0) {
+        if (reader->eof) { return 0; }    //End of input
+        if (fillLineReader(reader) == -1) { return -1; }
+    }
+    return length;
+}
+
+/*            freeLineReader
+ * Description: This function frees the block buffer of reader.
+ * Parameters: struct lineReader* reader
+ * Returns: void
+ * Preconditions: reader != NULL
+ */
+void freeLineReader(struct lineReader* reader) {
+    assert(reader != NULL);
+
+    free(reader->buffer);
+    reader->buffer = NULL;
+}
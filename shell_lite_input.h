@@ -0,0 +1,43 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_input.h
+* Description: This is the function declaration file for the line reader of the shellLite shell. Input is read from a file
+*              descriptor in large blocks and handed out one line at a time, so a script piped into the shell costs one
+*              read(2) per block instead of one per line.
+* Citations:
+*         1. Stevens, W. Richard "Advanced Programming in the UNIX Environment" 3.9 I/O Efficiency, Assisted with buffer sizing.
+*/
+#ifndef shell_lite_input_h
+#define shell_lite_input_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <assert.h>
+
+#define INPUT_BLOCK_SIZE 65536    //Bytes requested from read(2) at a time
+
+                            /* Struct for a buffered line reader */
+struct lineReader {
+    int fd;               //Descriptor lines are read from
+    char* buffer;         //Holds the current block, lines are null terminated in place
+    size_t capacity;      //Size of buffer
+    size_t start;         //Start of the next unread line
+    size_t end;           //End of data read into buffer
+    int eof;              //1 once read(2) returned 0
+};
+
+void initLineReader(struct lineReader*, int);    //Allocates the block buffer for fd
+
+ssize_t readLine(struct lineReader*, char**);    //Returns the next line, 0 at end of input, -1 if interrupted
+
+ssize_t takeLine(struct lineReader*, char**);    //Returns the next buffered line without reading, 0 if there is none
+
+ssize_t fillLineReader(struct lineReader*);    //Makes one read into the buffer, 0 at end of input, -1 if interrupted
+
+void freeLineReader(struct lineReader*);    //Frees the block buffer
+
+#endif /* shell_lite_input_h */
@@ -0,0 +1,814 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_jobs.c
+* Description: This is the function implementation file for the job table of the shellLite shell. Children are looked up by
+*              pid in a chained hash table and background jobs are removed from their list by moving the last job into the
+*              freed slot, so reaping n jobs costs O(n) instead of O(n^2).
+* Citations:
+*         1. Brewster, Benjamin "Process Management & Zombies" Assisted with design for process management.
+*         2. signalfd(2) Linux manual page, Assisted with receiving SIGCHLD as a file descriptor.
+*         3. "Control Group v2" Linux kernel documentation, Assisted with cgroup.procs and cgroup.kill.
+*/
+#include "shell_lite_jobs.h"
+#include "shell_lite_stats.h"
+#include "shell_lite_trace.h"
+
+/*            shellSignals
+ * Description: This function fills mask with the signals the shell blocks and reads from its signalfd. Children remove them from their mask
+ *         before exec.
+ * Parameters: sigset_t* mask
+ * Returns: void
+ * Preconditions: mask != NULL
+ */
+void shellSignals(sigset_t* mask) {
+    assert(mask != NULL);
+
+    sigemptyset(mask);
+    sigaddset(mask, SIGCHLD);
+    sigaddset(mask, SIGINT);
+    sigaddset(mask, SIGTSTP);
+}
+
+/*            initJobTable
+ * Description: This function blocks SIGCHLD, SIGINT and SIGTSTP so they are only delivered through the job table's signalfd, and allocates
+ *         room for the first JOB_START_CAPACITY background jobs. The signals keep their default action, an ignored signal never reaches a signalfd.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void initJobTable(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    sigset_t mask;
+    shellSignals(&mask);
+    sigprocmask(SIG_BLOCK, &mask, NULL);    //Children unblock them again when they are launched
+    jobs->sigFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (jobs->sigFd == -1) { perror("signalfd() error\n"); exit(1); }
+
+    jobs->list = malloc(JOB_START_CAPACITY * sizeof(struct process*));
+    jobs->finished = malloc(JOB_START_CAPACITY * sizeof(struct process*));
+    jobs->buckets = calloc(JOB_START_BUCKETS, sizeof(struct process*));
+    assert(jobs->list != NULL && jobs->finished != NULL && jobs->buckets != NULL);
+    jobs->count = 0;
+    jobs->capacity = JOB_START_CAPACITY;
+    jobs->bucketCount = JOB_START_BUCKETS;
+    jobs->tracked = 0;
+    jobs->finishedCount = 0;
+    jobs->timing = 0;
+    jobs->foregroundPgid = 0;
+    jobs->foregroundOnly = 0;
+    jobs->modeChanged = 0;
+    jobs->interrupted = 0;
+    jobs->nextJobId = 1;
+    jobs->cgroupFd = -1;
+    jobs->cgroupPath = NULL;
+    jobs->cgroupTried = 0;
+}
+
+/*            freeJobTable
+ * Description: This function frees every background job and closes the signalfd.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void freeJobTable(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    int i;
+    for (i = 0; i < jobs->count; i++) {
+        free(jobs->list[i]);
+        jobs->list[i] = NULL;
+    }
+    for (i = 0; i < jobs->finishedCount; i++) {
+        free(jobs->finished[i]);
+    }
+    free(jobs->list);
+    free(jobs->finished);
+    free(jobs->buckets);
+    close(jobs->sigFd);
+    if (jobs->cgroupFd != -1) {
+        close(jobs->cgroupFd);
+        rmdir(jobs->cgroupPath);    //Fails while a job that escaped the sweep is alive, the directory is left for it
+    }
+    free(jobs->cgroupPath);
+}
+
+/*            trackProcess
+ * Description: This function adds p to the pid hash table so reapChildren can record its status, and stamps its start time. The table doubles
+ *         when it holds more processes than buckets.
+ * Parameters: struct jobTable* jobs, struct process* p
+ * Returns: void
+ * Preconditions: jobs != NULL, p != NULL, p->pid > 0
+ */
+void trackProcess(struct jobTable* jobs, struct process* p) {
+    assert(jobs != NULL && p != NULL && p->pid > 0);
+
+    int i;
+    struct process* e;
+
+    if (jobs->tracked >= jobs->bucketCount) {
+        /* Grow and rehash */
+        int newCount = jobs->bucketCount * 2;
+        struct process** newBuckets = calloc(newCount, sizeof(struct process*));
+        assert(newBuckets != NULL);
+        for (i = 0; i < jobs->bucketCount; i++) {
+            while (jobs->buckets[i] != NULL) {
+                e = jobs->buckets[i];
+                jobs->buckets[i] = e->next;
+                e->next = newBuckets[e->pid & (newCount - 1)];
+                newBuckets[e->pid & (newCount - 1)] = e;
+            }
+        }
+        free(jobs->buckets);
+        jobs->buckets = newBuckets;
+        jobs->bucketCount = newCount;
+    }
+
+    p->done = 0;
+    clock_gettime(CLOCK_MONOTONIC, &p->start);
+    p->next = jobs->buckets[p->pid & (jobs->bucketCount - 1)];
+    jobs->buckets[p->pid & (jobs->bucketCount - 1)] = p;
+    jobs->tracked++;
+}
+
+/*            openJobCgroup
+ * Description: Creates the shell's job cgroup, shellLite-<pid> below the shell's own cgroup in the cgroup v2 hierarchy, and opens its
+ *         cgroup.procs. A child cgroup is the one a delegated user may create. Any failure, a v1 only system or a hierarchy the user may not
+ *         write to, leaves cgroupFd at -1 and jobs are only killed by process group. The shell stays in its own cgroup, so when that cgroup
+ *         enables controllers for its children the no internal processes rule makes moving a job fail with EBUSY, addJob drops the cgroup then.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+static void openJobCgroup(struct jobTable* jobs) {
+    char line[PATH_MAX];
+    char mount[PATH_MAX] = "";
+    char own[PATH_MAX] = "";
+    char path[PATH_MAX * 2 + 32];
+    char fsType[64];
+    int dirFd;
+    FILE* file;
+
+    jobs->cgroupTried = 1;
+
+    /* Mount point of the v2 hierarchy, /sys/fs/cgroup or /sys/fs/cgroup/unified on hybrid systems */
+    file = fopen("/proc/self/mountinfo", "re");
+    if (file == NULL) { return; }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char* dash = strstr(line, " - ");
+        if (dash != NULL && sscanf(dash, " - %63s", fsType) == 1 && strcmp(fsType, "cgroup2") == 0) {
+            sscanf(line, "%*s %*s %*s %*s %4095s", mount);
+            break;
+        }
+    }
+    fclose(file);
+
+    /* The shell's own cgroup is the 0:: line */
+    file = fopen("/proc/self/cgroup", "re");
+    if (file == NULL) { return; }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "0::", 3) == 0) {
+            sscanf(line + 3, "%4095s", own);
+            break;
+        }
+    }
+    fclose(file);
+    if (mount[0] == '\0' || own[0] == '\0') { return; }
+
+    snprintf(path, sizeof(path), "%s%s/shellLite-%d", mount, strcmp(own, "/") == 0 ? "" : own, (int)getpid());
+    if (mkdir(path, 0755) == -1) { return; }
+    dirFd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd != -1) {
+        jobs->cgroupFd = openat(dirFd, "cgroup.procs", O_WRONLY | O_CLOEXEC);
+        close(dirFd);
+    }
+    if (jobs->cgroupFd == -1) {
+        rmdir(path);
+        return;
+    }
+    jobs->cgroupPath = strdup(path);
+    assert(jobs->cgroupPath != NULL);
+}
+
+/*            addJob
+ * Description: This function creates a background process for pid, adds it to the list of background jobs and tracks it. Processes with the same
+ *         process group form one job and share its number, a new group gets the next number. The process is moved into the job cgroup when there
+ *         is one. The list and the finished queue double together when they are full, a job moves from one to the other so together they never
+ *         hold more than capacity jobs.
+ * Parameters: struct jobTable* jobs, pid_t pid, pid_t pgid
+ * Returns: struct process* for the job
+ * Preconditions: jobs != NULL, pid > 0, pgid > 0
+ */
+struct process* addJob(struct jobTable* jobs, pid_t pid, pid_t pgid) {
+    assert(jobs != NULL && pid > 0 && pgid > 0);
+
+    char text[16];
+    int length;
+
+    if (jobs->count + jobs->finishedCount >= jobs->capacity) {
+        jobs->capacity *= 2;
+        jobs->list = realloc(jobs->list, jobs->capacity * sizeof(struct process*));
+        jobs->finished = realloc(jobs->finished, jobs->capacity * sizeof(struct process*));
+        assert(jobs->list != NULL && jobs->finished != NULL);
+    }
+
+    struct process* p = malloc(sizeof(struct process));    //Dynamically allocate memory for new process struct
+    assert(p != NULL);
+    initProcess(p);
+    p->pid = pid;
+    p->background = 1;
+    p->timed = jobs->timing;
+    p->pgid = pgid;
+
+    /* Stages of a pipeline are added one after the other, so only the last job can share the group */
+    if (jobs->count > 0 && jobs->list[jobs->count - 1]->pgid == pgid) {
+        p->jobId = jobs->list[jobs->count - 1]->jobId;
+    } else {
+        if (jobs->count == 0) { jobs->nextJobId = 1; }
+        p->jobId = jobs->nextJobId++;
+    }
+
+    if (!jobs->cgroupTried) { openJobCgroup(jobs); }
+    if (jobs->cgroupFd != -1) {
+        length = snprintf(text, sizeof(text), "%d", (int)pid);
+        if (write(jobs->cgroupFd, text, length) == -1 && errno == EBUSY) {    //ESRCH for a job that already exited, it needs no killing
+            /* The shell's cgroup has controllers in cgroup.subtree_control, no process may join ours, see openJobCgroup */
+            close(jobs->cgroupFd);
+            jobs->cgroupFd = -1;
+            rmdir(jobs->cgroupPath);
+        }
+    }
+
+    p->slot = jobs->count;
+    jobs->list[jobs->count] = p;
+    jobs->count++;
+    trackProcess(jobs, p);
+    return p;
+}
+
+/*            untrackProcess
+ * Description: Removes p from the pid hash table, and from the background list by moving the last job into its slot.
+ * Parameters: struct jobTable* jobs, struct process* p
+ * Returns: void
+ * Preconditions: jobs != NULL, p != NULL
+ */
+static void untrackProcess(struct jobTable* jobs, struct process* p) {
+    struct process** link = &jobs->buckets[p->pid & (jobs->bucketCount - 1)];
+    while (*link != NULL && *link != p) {
+        link = &(*link)->next;
+    }
+    if (*link == p) {
+        *link = p->next;
+        jobs->tracked--;
+    }
+    p->next = NULL;
+
+    if (p->slot >= 0) {
+        jobs->count--;
+        jobs->list[p->slot] = jobs->list[jobs->count];    //Close gap with the last job
+        jobs->list[p->slot]->slot = p->slot;
+        jobs->list[jobs->count] = NULL;
+        p->slot = -1;
+    }
+}
+
+/*            stopForeground
+ * Description: This function turns the foreground processes in procs that have not finished, because CTRL-Z or a stop signal stopped them, into
+ *         one background job of group pgid. jobs lists it and fg or bg resume it. procs stops being tracked, the job has its own copies.
+ * Parameters: struct jobTable* jobs, struct process* procs, int n, pid_t pgid
+ * Returns: number of the job, 0 if every process had finished
+ * Preconditions: jobs != NULL, procs != NULL, pgid > 0 and is not the shell's group, every process with pid > 0 is tracked or reaped
+ */
+int stopForeground(struct jobTable* jobs, struct process* procs, int n, pid_t pgid) {
+    assert(jobs != NULL && procs != NULL && pgid > 0);
+
+    struct process* job;
+    int jobId = 0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (procs[i].pid <= 0 || procs[i].done) { continue; }
+        untrackProcess(jobs, &procs[i]);
+        job = addJob(jobs, procs[i].pid, pgid);    //Consecutive processes of one group share the job number
+        job->start = procs[i].start;
+        job->stopped = procs[i].stopped;
+        jobId = job->jobId;
+    }
+    return jobId;
+}
+
+/*            reapChildren
+ * Description: This function drains the signalfd and reaps every finished child with wait4(-1, WNOHANG | WUNTRACED | WCONTINUED). SIGINT is forwarded to the foreground
+ *         process group when it is not the shell's own, SIGTSTP toggles foreground-only mode. Stops and continues only update the stopped flag. Each reaped child is looked up in the pid hash table,
+ *         its status, end time and resource usage recorded and it is marked done. Background jobs are queued in finished to be reported at the next prompt.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void reapChildren(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    struct signalfd_siginfo info[16];
+    struct process* p;
+    pid_t pid;
+    int exitStatus = -5;
+    struct rusage usage;
+    ssize_t numRead;
+    size_t i;
+
+    /* Several SIGCHLDs may have merged, the wait4 loop below handles them all */
+    while ((numRead = read(jobs->sigFd, info, sizeof(info))) > 0) {
+        for (i = 0; i < numRead / sizeof(info[0]); i++) {
+            if (info[i].ssi_signo == SIGINT) {
+                jobs->interrupted = 1;    //Ends wait and fg
+                if (jobs->foregroundPgid > 0) {
+                    kill(-jobs->foregroundPgid, SIGINT);    //The terminal only signals the shell's group
+                }
+            } else if (info[i].ssi_signo == SIGTSTP) {
+                jobs->foregroundOnly = !jobs->foregroundOnly;
+                jobs->modeChanged = !jobs->modeChanged;    //Two toggles before the prompt cancel out
+            }
+        }
+    }
+
+    while ((pid = wait4(-1, &exitStatus, WNOHANG | WUNTRACED | WCONTINUED, &usage)) > 0) {
+        for (p = jobs->buckets[pid & (jobs->bucketCount - 1)]; p != NULL && p->pid != pid; p = p->next) { }
+        if (p == NULL) { continue; }    //Not launched through the job table
+
+        /* Stopped and continued processes stay tracked, jobs shows their state and bg or fg resume them */
+        if (WIFSTOPPED(exitStatus)) { p->stopped = 1; continue; }
+        if (WIFCONTINUED(exitStatus)) { p->stopped = 0; continue; }
+
+        clock_gettime(CLOCK_MONOTONIC, &p->end);
+        p->usage = usage;
+
+        /* EXIT case */
+        if (WIFEXITED(exitStatus)) {
+            p->exitValue = WEXITSTATUS(exitStatus);
+        }
+
+        /* SIGNAL Case */
+        if (WIFSIGNALED(exitStatus)) {
+            p->signalValue = WTERMSIG(exitStatus);
+        }
+
+        p->done = 1;
+        untrackProcess(jobs, p);
+        if (traceEnabled) { traceExit(p); }
+        if (p->background) {
+            statsCount(STATS_REAPED);
+            jobs->finished[jobs->finishedCount++] = p;    //Reported by backgroundChecker
+        }
+    }
+}
+
+/*            waitForChildEvent
+ * Description: This function blocks until SIGCHLD arrives on the signalfd, then reaps every finished child.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void waitForChildEvent(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    struct pollfd fd;
+    fd.fd = jobs->sigFd;
+    fd.events = POLLIN;
+    fd.revents = 0;
+
+    if (poll(&fd, 1, -1) == -1 && errno != EINTR) {
+        perror("poll() error in waitForChildEvent\n");
+    }
+    reapChildren(jobs);
+}
+
+/*            waitForProcess
+ * Description: This function blocks until p has been reaped or has stopped. Other children that finish in the meantime are reaped too, so
+ *         background jobs do not stay zombies while a foreground command runs. A stopped p is still tracked, the caller resumes it or makes it a job.
+ * Parameters: struct jobTable* jobs, struct process* p
+ * Returns: void
+ * Preconditions: jobs != NULL, p != NULL, p is tracked
+ */
+void waitForProcess(struct jobTable* jobs, struct process* p) {
+    assert(jobs != NULL && p != NULL);
+
+    long long waited = traceEnabled ? statsNow() : 0;    //Pipeline stages are waited for one after another, their wait spans do not overlap
+
+    reapChildren(jobs);
+    while (!p->done && !p->stopped) {
+        waitForChildEvent(jobs);
+    }
+    if (traceEnabled) { traceSpan("wait", waited, statsNow(), p->pid); }
+    if (p->done) {
+        statsRecord(STATS_WAIT, (p->end.tv_sec - p->start.tv_sec) * 1000000000LL + (p->end.tv_nsec - p->start.tv_nsec));
+    }
+}
+
+/*            waitForCommand
+ * Description: This function waits like waitForProcess for a foreground command that cannot become a job: one in the shell's own process group,
+ *         where kill %n or exit would signal the shell as well, or a pipeline stage the shell's splice relay feeds. A stop is answered with SIGCONT
+ *         and the wait goes on. For the shell's group CTRL-Z has already toggled foreground-only mode.
+ * Parameters: struct jobTable* jobs, struct process* p
+ * Returns: void
+ * Preconditions: jobs != NULL, p != NULL, p is tracked
+ */
+void waitForCommand(struct jobTable* jobs, struct process* p) {
+    assert(jobs != NULL && p != NULL);
+
+    waitForProcess(jobs, p);
+    while (p->stopped) {
+        p->stopped = 0;    //Set again if it stops before it finishes
+        kill(p->pid, SIGCONT);
+        waitForProcess(jobs, p);
+    }
+}
+
+/*            giveTerminal
+ * Description: This function makes pgid the foreground process group of the terminal when the shell owns it, so the commands in the group can
+ *         read it without being stopped by SIGTTIN and CTRL-C and CTRL-Z reach them directly.
+ * Parameters: pid_t pgid
+ * Returns: 1 if the terminal was handed over, 0 if the shell does not own a terminal
+ * Preconditions: pgid > 0
+ */
+int giveTerminal(pid_t pgid) {
+    assert(pgid > 0);
+
+    if (!isatty(STDIN_FILENO) || tcgetpgrp(STDIN_FILENO) != getpgrp()) { return 0; }
+    return tcsetpgrp(STDIN_FILENO, pgid) == 0;
+}
+
+/*            reclaimTerminal
+ * Description: This function makes the shell's group the foreground process group of the terminal again after giveTerminal.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: giveTerminal returned 1
+ */
+void reclaimTerminal(void) {
+    sigset_t ttou, old;
+
+    /* The shell is a background group now, tcsetpgrp would stop it with SIGTTOU unless it is blocked */
+    sigemptyset(&ttou);
+    sigaddset(&ttou, SIGTTOU);
+    sigprocmask(SIG_BLOCK, &ttou, &old);
+    tcsetpgrp(STDIN_FILENO, getpgrp());
+    sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+/*            addUsage
+ * Description: This function adds the CPU times, faults and context switches of part to total. Max RSS is a peak, total keeps the larger one.
+ * Parameters: struct rusage* total, struct rusage* part
+ * Returns: void
+ * Preconditions: total != NULL, part != NULL
+ */
+void addUsage(struct rusage* total, struct rusage* part) {
+    assert(total != NULL && part != NULL);
+
+    timeradd(&total->ru_utime, &part->ru_utime, &total->ru_utime);
+    timeradd(&total->ru_stime, &part->ru_stime, &total->ru_stime);
+    if (part->ru_maxrss > total->ru_maxrss) { total->ru_maxrss = part->ru_maxrss; }
+    total->ru_majflt += part->ru_majflt;
+    total->ru_minflt += part->ru_minflt;
+    total->ru_nvcsw += part->ru_nvcsw;
+    total->ru_nivcsw += part->ru_nivcsw;
+}
+
+/*            terminateJobs
+ * Description: This function kills every background job with SIGKILL. With a job cgroup one write to cgroup.kill kills every job and anything
+ *         they started, the sweep over the jobs' process groups catches processes that were forked before their job joined the cgroup and is the
+ *         only step without one. The killed jobs are then reaped for at most JOB_EXIT_WAIT_MS, so none of them outlives the shell as a zombie.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void terminateJobs(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    int i;
+    int dirFd, killFd;
+    long long deadline;
+    long long left;
+    struct pollfd fd;
+
+    if (jobs->cgroupFd != -1) {
+        dirFd = open(jobs->cgroupPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        killFd = dirFd == -1 ? -1 : openat(dirFd, "cgroup.kill", O_WRONLY | O_CLOEXEC);
+        if (killFd != -1) {
+            write(killFd, "1", 1);    //Kernels before 5.14 have no cgroup.kill, the sweep below does the work then
+            close(killFd);
+        }
+        if (dirFd != -1) { close(dirFd); }
+    }
+
+    /* One kill per process group, pipeline stages share theirs */
+    for (i = 0; i < jobs->count; i++) {
+        if (i == 0 || jobs->list[i]->pgid != jobs->list[i - 1]->pgid) {
+            kill(-jobs->list[i]->pgid, SIGKILL);
+        }
+    }
+
+    deadline = statsNow() + JOB_EXIT_WAIT_MS * 1000000LL;
+    fd.fd = jobs->sigFd;
+    fd.events = POLLIN;
+    reapChildren(jobs);
+    while (jobs->count > 0 && (left = deadline - statsNow()) > 0) {
+        fd.revents = 0;
+        if (poll(&fd, 1, (int)(left / 1000000) + 1) == -1 && errno != EINTR) { break; }
+        reapChildren(jobs);
+    }
+}
+
+/*            findJob
+ * Description: Looks up a job by a %n argument, or the most recent job when spec is NULL. An error is printed when there is no such job.
+ * Parameters: struct jobTable* jobs, char* spec
+ * Returns: any process of the job, NULL if there is none
+ * Preconditions: jobs != NULL
+ */
+static struct process* findJob(struct jobTable* jobs, char* spec) {
+    int i;
+    int id = 0;
+    char* end;
+    struct process* found = NULL;
+
+    if (spec != NULL) {
+        id = (int)strtol(spec[0] == '%' ? spec + 1 : spec, &end, 10);
+        if (*end != '\0' || id <= 0) {
+            fprintf(stderr, "Error, %s is not a job, use %%n\n", spec);
+            return NULL;
+        }
+    }
+    for (i = 0; i < jobs->count; i++) {
+        if (id == 0 ? (found == NULL || jobs->list[i]->jobId > found->jobId) : jobs->list[i]->jobId == id) {
+            found = jobs->list[i];
+        }
+    }
+    if (found == NULL) {
+        fprintf(stderr, "Error, no such job %s\n", spec != NULL ? spec : "");
+    }
+    return found;
+}
+
+/*            compareJobs
+ * Description: qsort comparison putting processes in job number order, then pid order.
+ * Parameters: const void* a, const void* b
+ * Returns: < 0, 0 or > 0
+ * Preconditions: a and b point at struct process*
+ */
+static int compareJobs(const void* a, const void* b) {
+    struct process* x = *(struct process* const*)a;
+    struct process* y = *(struct process* const*)b;
+    if (x->jobId != y->jobId) { return x->jobId - y->jobId; }
+    return (x->pid > y->pid) - (x->pid < y->pid);
+}
+
+/*            jobsCommand
+ * Description: This function runs the jobs builtin. Every background job is listed once in number order with its state and the pids of its
+ *         processes. A job is Stopped when all of its running processes are stopped.
+ * Parameters: struct jobTable* jobs
+ * Returns: void
+ * Preconditions: jobs != NULL
+ */
+void jobsCommand(struct jobTable* jobs) {
+    assert(jobs != NULL);
+
+    int i, j;
+    int stopped;
+    struct process** sorted;
+
+    reapChildren(jobs);
+    if (jobs->count == 0) { return; }
+    sorted = malloc(jobs->count * sizeof(struct process*));
+    assert(sorted != NULL);
+    memcpy(sorted, jobs->list, jobs->count * sizeof(struct process*));
+    qsort(sorted, jobs->count, sizeof(struct process*), compareJobs);
+
+    for (i = 0; i < jobs->count; i = j) {
+        stopped = 1;
+        for (j = i; j < jobs->count && sorted[j]->jobId == sorted[i]->jobId; j++) {
+            if (!sorted[j]->stopped) { stopped = 0; }
+        }
+        printf("[%d] %-8s", sorted[i]->jobId, stopped ? "Stopped" : "Running");
+        for (j = i; j < jobs->count && sorted[j]->jobId == sorted[i]->jobId; j++) {
+            printf(" %d", sorted[j]->pid);
+        }
+        printf("\n");
+    }
+    free(sorted);
+}
+
+/*            fgCommand
+ * Description: This function runs the fg builtin. The job, %n or the most recent one, is continued and waited on like a foreground command: it
+ *         gets the terminal when the shell has it, CTRL-C reaches it and status reports its last process afterwards. A job that stops again goes
+ *         back to the background.
+ * Parameters: char** args, int count, struct process* lastForeground, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, lastForeground != NULL, jobs != NULL
+ */
+void fgCommand(char** args, int count, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && lastForeground != NULL && jobs != NULL);
+
+    int i, n = 0;
+    int running;
+    int terminal;
+    struct process* job;
+    struct process* last = NULL;
+    struct process** members;
+
+    reapChildren(jobs);
+    job = findJob(jobs, count > 1 ? args[1] : NULL);
+    if (job == NULL) { return; }
+
+    /* Take the job's processes out of the background list, they are reported through status instead */
+    members = malloc(jobs->count * sizeof(struct process*));
+    assert(members != NULL);
+    for (i = 0; i < jobs->count; i++) {
+        if (jobs->list[i]->jobId == job->jobId) {
+            members[n++] = jobs->list[i];
+        }
+    }
+    for (i = 0; i < n; i++) {
+        members[i]->background = 0;
+    }
+    job = members[0];
+
+    terminal = giveTerminal(job->pgid);
+    jobs->foregroundPgid = job->pgid;
+    jobs->interrupted = 0;
+    for (i = 0; i < n; i++) {
+        members[i]->stopped = 0;    //Set again if the job stops before it finishes
+    }
+    kill(-job->pgid, SIGCONT);
+
+    /* Wait until every process is done or the ones left are stopped again */
+    do {
+        running = 0;
+        for (i = 0; i < n; i++) {
+            if (!members[i]->done && !members[i]->stopped) { running = 1; }
+        }
+        if (running) { waitForChildEvent(jobs); }
+    } while (running);
+
+    jobs->foregroundPgid = 0;
+    if (terminal) { reclaimTerminal(); }
+
+    for (i = 0; i < n; i++) {
+        if (!members[i]->done) {
+            members[i]->background = 1;    //Stopped again, stays a job
+            continue;
+        }
+        if (last == NULL || members[i]->start.tv_sec > last->start.tv_sec ||
+            (members[i]->start.tv_sec == last->start.tv_sec && members[i]->start.tv_nsec >= last->start.tv_nsec)) {
+            last = members[i];    //Last stage launched
+        }
+    }
+    if (last != NULL) {
+        *lastForeground = *last;
+        lastForeground->next = NULL;
+        lastForeground->slot = -1;
+        if (lastForeground->signalValue >= 0) {
+            status(lastForeground);    //Print signal that terminated the job
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (members[i]->done) { free(members[i]); }
+    }
+    if (last == NULL) {
+        printf("[%d] Stopped\n", job->jobId);
+    }
+    free(members);
+}
+
+/*            bgCommand
+ * Description: This function runs the bg builtin, continuing the stopped job %n, or the most recent job, in the background.
+ * Parameters: char** args, int count, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, jobs != NULL
+ */
+void bgCommand(char** args, int count, struct jobTable* jobs) {
+    assert(args != NULL && jobs != NULL);
+
+    int i;
+    struct process* job;
+
+    reapChildren(jobs);
+    job = findJob(jobs, count > 1 ? args[1] : NULL);
+    if (job == NULL) { return; }
+    if (kill(-job->pgid, SIGCONT) == -1) {
+        perror("kill() error\n");
+        return;
+    }
+    for (i = 0; i < jobs->count; i++) {
+        if (jobs->list[i]->jobId == job->jobId) { jobs->list[i]->stopped = 0; }
+    }
+    printf("[%d] continued\n", job->jobId);
+}
+
+/*            findJobArgument
+ * Description: This function checks whether any argument after the command is a %n job reference.
+ * Parameters: char** args, int count
+ * Returns: 1 if one is, 0 if not
+ * Preconditions: args != NULL
+ */
+int findJobArgument(char** args, int count) {
+    assert(args != NULL);
+
+    int i;
+    for (i = 1; i < count; i++) {
+        if (args[i][0] == '%') { return 1; }
+    }
+    return 0;
+}
+
+/*            killCommand
+ * Description: This function runs the kill builtin, which commandHandler only uses when an argument names a job: kill [-SIGNAL] %n|pid ...
+ *         A job is signalled through its process group so every stage gets the signal. SIGNAL is a number or a name with or without SIG.
+ * Parameters: char** args, int count, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, jobs != NULL
+ */
+void killCommand(char** args, int count, struct jobTable* jobs) {
+    assert(args != NULL && jobs != NULL);
+
+    static const struct { const char* name; int signo; } names[] = {
+        { "HUP", SIGHUP }, { "INT", SIGINT }, { "QUIT", SIGQUIT }, { "KILL", SIGKILL }, { "USR1", SIGUSR1 }, { "USR2", SIGUSR2 },
+        { "TERM", SIGTERM }, { "CONT", SIGCONT }, { "STOP", SIGSTOP }, { "TSTP", SIGTSTP }
+    };
+    int signo = SIGTERM;
+    int first = 1;
+    int i;
+    char* name;
+    char* end;
+    pid_t target;
+    struct process* job;
+
+    reapChildren(jobs);
+    if (count > 1 && args[1][0] == '-') {
+        name = args[1] + 1;
+        if (strncmp(name, "SIG", 3) == 0) { name += 3; }
+        signo = (int)strtol(name, &end, 10);
+        if (*end != '\0' || end == name) {
+            signo = -1;
+            for (i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+                if (strcmp(name, names[i].name) == 0) { signo = names[i].signo; }
+            }
+        }
+        if (signo < 0 || signo >= NSIG) {
+            fprintf(stderr, "Error, unknown signal %s\n", args[1]);
+            return;
+        }
+        first = 2;
+    }
+
+    for (i = first; i < count; i++) {
+        if (args[i][0] == '%') {
+            job = findJob(jobs, args[i]);
+            if (job == NULL) { continue; }
+            target = -job->pgid;
+        } else {
+            target = (pid_t)strtol(args[i], &end, 10);
+            if (*end != '\0' || target <= 0) {
+                fprintf(stderr, "Error, %s is not a pid or %%n\n", args[i]);
+                continue;
+            }
+        }
+        if (kill(target, signo) == -1) {
+            fprintf(stderr, "kill %s: %s\n", args[i], strerror(errno));
+        }
+    }
+}
+
+/*            waitCommand
+ * Description: This function runs the wait builtin, blocking until job %n or pid, or every running background job, has finished. Finished jobs
+ *         are reported at the next prompt as usual. Stopped jobs are not waited for and CTRL-C ends the wait.
+ * Parameters: char** args, int count, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, jobs != NULL
+ */
+void waitCommand(char** args, int count, struct jobTable* jobs) {
+    assert(args != NULL && jobs != NULL);
+
+    int i;
+    int id = 0;          //Job waited for, 0 for all
+    pid_t pid = 0;       //Process waited for, 0 for a job
+    int pending;
+    struct process* job;
+
+    reapChildren(jobs);
+    if (count > 1 && args[1][0] == '%') {
+        job = findJob(jobs, args[1]);
+        if (job == NULL) { return; }
+        id = job->jobId;
+    } else if (count > 1) {
+        pid = (pid_t)atoi(args[1]);
+    }
+
+    jobs->interrupted = 0;
+    do {
+        pending = 0;
+        for (i = 0; i < jobs->count; i++) {
+            struct process* p = jobs->list[i];
+            if (!p->stopped && (pid != 0 ? p->pid == pid : id == 0 || p->jobId == id)) { pending = 1; }
+        }
+        if (pending) { waitForChildEvent(jobs); }
+    } while (pending && !jobs->interrupted);
+}
@@ -0,0 +1,95 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_jobs.h
+* Description: This is the function declaration file for the job table of the shellLite shell. Every child the shell waits
+*              on is tracked in a pid hash table, so reaping a child is O(1) no matter how many jobs are running. SIGCHLD is
+*              blocked and delivered through a signalfd, and children are reaped with wait4(-1, WNOHANG | WUNTRACED |
+*              WCONTINUED) whenever it is readable, including while a foreground command runs, so finished background jobs never
+*              linger as zombies and stopped or continued children are noticed along with their resource usage.
+*              SIGINT and SIGTSTP arrive on the same signalfd, so the shell has no asynchronous signal handlers at all.
+*              Every background job leads its own process group and is numbered for %n. When the shell may create a cgroup v2
+*              below its own, background jobs are moved into it so exit can kill them all with one write to cgroup.kill.
+* Citations:
+*         1. Brewster, Benjamin "Process Management & Zombies" Assisted with design for process management.
+*         2. signalfd(2) Linux manual page, Assisted with receiving SIGCHLD as a file descriptor.
+*         3. "Control Group v2" Linux kernel documentation, Assisted with cgroup.procs and cgroup.kill.
+*/
+#ifndef shell_lite_jobs_h
+#define shell_lite_jobs_h
+
+#include "shell_lite_builtins.h"
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+
+#define JOB_START_BUCKETS 1024    //Initial pid hash bucket count, always a power of two
+#define JOB_START_CAPACITY 64     //Initial size of the background list, doubled as needed
+#define JOB_EXIT_WAIT_MS 2000     //Longest exit waits for killed jobs to be reaped
+
+                            /* Struct holding every child the shell is waiting on */
+struct jobTable {
+    struct process** list;       //Background jobs, each knows its own slot
+    int count;                   //Number of background jobs in list
+    int capacity;                //Slots allocated in list and in finished
+    struct process** buckets;    //pid -> process hash table, chained through process->next
+    int bucketCount;             //Number of buckets, power of two
+    int tracked;                 //Number of processes in the hash table
+    struct process** finished;   //Background jobs reaped but not yet reported
+    int finishedCount;           //Number of jobs in finished
+    int sigFd;                   //signalfd receiving SIGCHLD, SIGINT and SIGTSTP
+    int timing;                  //1 while a time prefix runs, background jobs added meanwhile report their usage
+    pid_t foregroundPgid;        //Process group SIGINT is forwarded to, 0 if the foreground command shares the shell's group
+    int foregroundOnly;          //1 while foreground-only mode is on, toggled by SIGTSTP
+    int modeChanged;             //1 if foregroundOnly changed since backgroundChecker last reported it
+    int interrupted;             //1 if SIGINT arrived since a builtin waiting on jobs last checked
+    int nextJobId;               //Number given to the next background job, back to 1 when there are none
+    int cgroupFd;                //cgroup.procs of the shell's job cgroup, -1 if there is none
+    char* cgroupPath;            //Directory of the job cgroup, removed by freeJobTable
+    int cgroupTried;             //1 once creating the job cgroup was attempted
+};
+
+void initJobTable(struct jobTable*);    //Blocks the shell's signals, opens the signalfd and allocates the table
+
+void shellSignals(sigset_t*);    //Fills a set with the signals the shell receives through its signalfd
+
+void freeJobTable(struct jobTable*);    //Frees every job and closes the signalfd
+
+void trackProcess(struct jobTable*, struct process*);    //Adds a launched child to the pid hash table
+
+struct process* addJob(struct jobTable*, pid_t, pid_t);    //Creates and tracks a background process of the job leading the given group
+
+void reapChildren(struct jobTable*);    //Handles pending signals, reaps every finished child and records its status
+
+void waitForChildEvent(struct jobTable*);    //Blocks until a child changes state, then reaps
+
+void waitForProcess(struct jobTable*, struct process*);    //Blocks until a tracked child has been reaped or has stopped
+
+void waitForCommand(struct jobTable*, struct process*);    //Like waitForProcess, a stopped child is continued instead
+
+int stopForeground(struct jobTable*, struct process*, int, pid_t);    //Makes stopped foreground processes a background job, returns its number
+
+int giveTerminal(pid_t);    //Makes a process group the terminal's foreground group, returns 1 if the shell owned the terminal
+
+void reclaimTerminal(void);    //Makes the shell's group the terminal's foreground group again
+
+void addUsage(struct rusage*, struct rusage*);    //Adds the second resource usage to the first, max RSS is the larger of both
+
+void terminateJobs(struct jobTable*);    //Kills every background job and reaps them, used by exit
+
+void jobsCommand(struct jobTable*);    //Runs the jobs builtin
+
+void fgCommand(char**, int, struct process*, struct jobTable*);    //Runs the fg builtin
+
+void bgCommand(char**, int, struct jobTable*);    //Runs the bg builtin
+
+void killCommand(char**, int, struct jobTable*);    //Runs the kill builtin for lines naming a %n job
+
+int findJobArgument(char**, int);    //Returns 1 if an argument names a %n job
+
+void waitCommand(char**, int, struct jobTable*);    //Runs the wait builtin
+
+#endif /* shell_lite_jobs_h */
@@ -0,0 +1,439 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_launch.c
+* Description: This is the function implementation file for the launch engine of the shellLite shell. All redirection work
+*              happens in the shell before the child exists, so the spawn path only has to replay a short list of file actions.
+* Citations:
+*         1. Brewster, Benjamin "Processes" Assisted with knowledge of getting process ids, using fork(), execvp().
+*         2. Brewster, Benjamin "More UNIX I/O" Assisted with I/O redirection
+*         3. posix_spawn(3) Linux manual page, Assisted with file actions and spawn attributes.
+*/
+#include "shell_lite_launch.h"
+#include "shell_lite_hash.h"
+#include "shell_lite_stats.h"
+#include "shell_lite_pool.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_trace.h"
+#include "shell_lite_heredoc.h"
+
+static int nextCpu = 0;    //Position of the next @cpu=rr command among the shell's CPUs
+
+/*            parseCpuList
+ * Description: Fills cpus from a list such as 0-3,6. rr picks the next of the CPUs the shell may run on, wrapping around.
+ * Parameters: char* list, cpu_set_t* cpus
+ * Returns: 0 on success, -1 if the list is malformed
+ * Preconditions: list != NULL, cpus != NULL
+ */
+static int parseCpuList(char* list, cpu_set_t* cpus) {
+    cpu_set_t allowed;
+    char* end;
+    long first, last, cpu;
+    int count, i;
+
+    CPU_ZERO(cpus);
+    if (strcmp(list, "rr") == 0) {
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == -1) { return -1; }
+        count = CPU_COUNT(&allowed);
+        nextCpu %= count;
+        for (i = 0, cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed) && i++ == nextCpu) { break; }
+        }
+        CPU_SET(cpu, cpus);
+        nextCpu++;
+        return 0;
+    }
+
+    while (*list != '\0') {
+        first = strtol(list, &end, 10);
+        if (end == list || first < 0) { return -1; }
+        last = first;
+        if (*end == '-') {
+            list = end + 1;
+            last = strtol(list, &end, 10);
+            if (end == list || last < first) { return -1; }
+        }
+        if (last >= CPU_SETSIZE) { return -1; }
+        for (cpu = first; cpu <= last; cpu++) { CPU_SET(cpu, cpus); }
+        if (*end == ',') { end++; }
+        else if (*end != '\0') { return -1; }
+        list = end;
+    }
+    return CPU_COUNT(cpus) > 0 ? 0 : -1;
+}
+
+/*            parseModifier
+ * Description: Records one @name=value launch modifier in plan.
+ * Parameters: char* word, struct launchPlan* plan
+ * Returns: 0 on success, -1 if the modifier is unknown or its value malformed or out of range
+ * Preconditions: word != NULL, word[0] == '@', plan != NULL
+ */
+static int parseModifier(char* word, struct launchPlan* plan) {
+    char* value = strchr(word, '=');
+    char* end;
+    unsigned long long size;
+    long niceValue;
+    int shift = 0;    //log2 of the size suffix
+
+    if (value == NULL) { return -1; }
+    value++;
+    plan->limited = 1;
+
+    if (strncmp(word, "@cpu=", 5) == 0) {
+        plan->hasCpus = 1;
+        return parseCpuList(value, &plan->cpus);
+    }
+    if (strncmp(word, "@nice=", 6) == 0) {
+        errno = 0;
+        niceValue = strtol(value, &end, 10);
+        if (errno != 0 || end == value || *end != '\0' || niceValue < NICE_MIN || niceValue > NICE_MAX) { return -1; }
+        plan->niceValue = (int)niceValue;
+        plan->hasNice = 1;
+        return 0;
+    }
+    if (strncmp(word, "@mem=", 5) == 0) {
+        if (*value < '0' || *value > '9') { return -1; }    //strtoull would accept a sign and wrap a negative size
+        errno = 0;
+        size = strtoull(value, &end, 10);
+        if (errno != 0 || size == 0) { return -1; }    //A limit of 0 kills the command before it runs
+        if (*end == 'K' || *end == 'k') { shift = 10; end++; }
+        else if (*end == 'M' || *end == 'm') { shift = 20; end++; }
+        else if (*end == 'G' || *end == 'g') { shift = 30; end++; }
+        if (*end != '\0' || size > (unsigned long long)RLIM_INFINITY >> shift) { return -1; }    //The shift would wrap around
+        plan->memLimit = (rlim_t)(size << shift);
+        return 0;
+    }
+    return -1;
+}
+
+/*            applyModifiers
+ * Description: Applies the launch modifiers of plan to the calling process, used by the child just before exec.
+ * Parameters: struct launchPlan* plan
+ * Returns: 0 on success, -1 on error with errno set
+ * Preconditions: plan != NULL
+ */
+static int applyModifiers(struct launchPlan* plan) {
+    struct rlimit limit;
+
+    if (plan->hasCpus && sched_setaffinity(0, sizeof(plan->cpus), &plan->cpus) == -1) { return -1; }
+    if (plan->hasNice && setpriority(PRIO_PROCESS, 0, plan->niceValue) == -1) { return -1; }
+    if (plan->memLimit != RLIM_INFINITY) {
+        limit.rlim_cur = plan->memLimit;
+        limit.rlim_max = plan->memLimit;    //The command cannot raise it again
+        if (setrlimit(RLIMIT_AS, &limit) == -1) { return -1; }
+    }
+    return 0;
+}
+
+/*            buildLaunchPlan
+ * Description: This function splits args into the argv of the command, the targets of <, > and >+, the text of << and <<< and the
+ *         background flag. argv holds pointers into args, nothing is copied. Leading @ words are launch modifiers. Returns -1 and prints an error if a redirection is
+ *         missing its target or a modifier is malformed.
+ * Parameters: char** args, int count, struct launchPlan* plan
+ * Returns: 0 on success, -1 on error
+ * Preconditions: args != NULL, count >= 1, plan != NULL
+ */
+int buildLaunchPlan(char** args, int count, struct launchPlan* plan) {
+    assert(args != NULL && count >= 1 && plan != NULL);
+
+    int i;
+    plan->argv = malloc((count + 1) * sizeof(char*));
+    plan->teeFiles = malloc(count * sizeof(char*));
+    assert(plan->argv != NULL && plan->teeFiles != NULL);
+    plan->argc = 0;
+    plan->inFile = NULL;
+    plan->hereText = NULL;
+    plan->hereString = 0;
+    plan->outFile = NULL;
+    plan->teeCount = 0;
+    plan->background = 0;
+    plan->inFd = -1;
+    plan->outFd = -1;
+    plan->pgid = -1;
+    plan->limited = 0;
+    plan->hasCpus = 0;
+    plan->hasNice = 0;
+    plan->niceValue = 0;
+    plan->memLimit = RLIM_INFINITY;
+
+    if (strcmp(args[count - 1], "&") == 0) {
+        plan->background = 1;
+        plan->pgid = 0;    //Own process group, CTRL-C at the terminal only reaches the foreground
+        count--;
+    }
+
+    for (i = 0; i < count && args[i][0] == '@'; i++) {
+        if (parseModifier(args[i], plan) == -1) {
+            fprintf(stderr, "Error, bad launch modifier %s\n", args[i]);
+            closeLaunchPlan(plan);
+            return -1;
+        }
+    }
+
+    for (; i < count; i++) {
+        if (strcmp(args[i], "<") == 0 || strcmp(args[i], "<<") == 0 || strcmp(args[i], "<<<") == 0 || strcmp(args[i], ">") == 0 || strcmp(args[i], ">+") == 0) {
+            if (i + 1 >= count) {
+                fprintf(stderr, "Error, missing word after %s\n", args[i]);
+                closeLaunchPlan(plan);
+                return -1;
+            }
+            if (args[i][0] == '<') {
+                /* The last input redirection wins */
+                plan->inFile = args[i][1] == '\0' ? args[i + 1] : NULL;
+                plan->hereText = args[i][1] == '\0' ? NULL : args[i + 1];
+                plan->hereString = args[i][1] != '\0' && args[i][2] == '<';
+            }
+            else if (args[i][1] == '+') { plan->teeFiles[plan->teeCount++] = args[i + 1]; }
+            else { plan->outFile = args[i + 1]; }
+            i++;    //Skip the redirection target
+        } else {
+            plan->argv[plan->argc++] = args[i];
+        }
+    }
+    plan->argv[plan->argc] = NULL;
+
+    if (plan->argc == 0) {
+        fprintf(stderr, "Error, missing command\n");
+        closeLaunchPlan(plan);
+        return -1;
+    }
+    return 0;
+}
+
+/*            openLaunchPlan
+ * Description: This function opens the redirection targets of plan in the shell, here-document and here-string text is staged in a
+ *         sealed memfd. Background commands without a target read from and write to /dev/null. Descriptors are opened O_CLOEXEC so only their dup2 copies reach the child.
+ * Parameters: struct launchPlan* plan
+ * Returns: 0 on success, -1 if a target could not be opened
+ * Preconditions: plan != NULL
+ */
+int openLaunchPlan(struct launchPlan* plan) {
+    assert(plan != NULL);
+
+    if (plan->inFile != NULL) {
+        plan->inFd = open(plan->inFile, O_RDONLY | O_CLOEXEC);    //Open file for reading only
+        if (plan->inFd == -1) { perror("open() error\n"); return -1; }
+    } else if (plan->hereText != NULL) {
+        plan->inFd = stageHereText(plan->hereText, plan->hereString);
+        if (plan->inFd == -1) { return -1; }
+    } else if (plan->background && plan->inFd == -1) {
+        plan->inFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        if (plan->inFd == -1) { perror("open() error\n"); return -1; }
+    }
+
+    if (plan->outFile != NULL) {
+        plan->outFd = open(plan->outFile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);    //Open file for writing only, create or Trunc
+        if (plan->outFd == -1) { perror("open() error\n"); return -1; }
+    } else if (plan->background && plan->outFd == -1) {
+        plan->outFd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (plan->outFd == -1) { perror("open() error\n"); return -1; }
+    }
+    return 0;
+}
+
+/*            closeLaunchPlan
+ * Description: This function closes the descriptors held by plan and frees its argv. Safe to call on a partially opened plan.
+ * Parameters: struct launchPlan* plan
+ * Returns: void
+ * Preconditions: plan != NULL
+ */
+void closeLaunchPlan(struct launchPlan* plan) {
+    assert(plan != NULL);
+
+    if (plan->inFd != -1) { close(plan->inFd); plan->inFd = -1; }
+    if (plan->outFd != -1) { close(plan->outFd); plan->outFd = -1; }
+    free(plan->argv);
+    free(plan->teeFiles);
+    plan->argv = NULL;
+    plan->teeFiles = NULL;
+}
+
+/*            launchCommand
+ * Description: This function starts the command described by plan in an idle pool helper when SHELLLITE_POOL is set, otherwise with the
+ *         posix_spawn engine, or with fork/exec when SHELLLITE_LAUNCH=fork is set in the environment or the plan has launch modifiers.
+ * Parameters: struct launchPlan* plan
+ * Returns: pid of the child, -1 on error
+ * Preconditions: plan != NULL, plan->argv != NULL
+ */
+pid_t launchCommand(struct launchPlan* plan) {
+    assert(plan != NULL && plan->argv != NULL);
+
+    pid_t pid;
+    long long started = statsNow();
+    char* engine = getenv("SHELLLITE_LAUNCH");
+
+    pid = plan->limited ? POOL_UNAVAILABLE : poolLaunch(plan);    //A pre-forked helper if SHELLLITE_POOL is set and one is idle
+    if (pid != POOL_UNAVAILABLE) {
+        long long handed = statsSince(STATS_FORK, started);
+        if (traceEnabled && pid != -1) {
+            traceLaunch(pid, plan->argv[0], started);
+            traceSpan("fork", started, handed, pid);    //Handoff to a pool helper, exec included
+        }
+    } else if (plan->limited || (engine != NULL && strcmp(engine, "fork") == 0)) {    //Modifiers are applied by the forked child
+        pid = forkCommand(plan);
+    } else {
+        pid = spawnCommand(plan);
+    }
+    if (pid != -1) { statsCount(STATS_COMMANDS); }
+    return pid;
+}
+
+/*            spawnCommand
+ * Description: This function starts plan with posix_spawnp. Redirections become dup2 file actions, foreground commands get SIGINT reset to
+ *         default and the process group is set through the spawn attributes. glibc implements this with clone(CLONE_VM|CLONE_VFORK) so the
+ *         shell's memory is never copied. The command is resolved through the command cache, posix_spawnp only searches PATH when the
+ *         cache has no answer. Exec failures are reported by the return value of posix_spawn.
+ * Parameters: struct launchPlan* plan
+ * Returns: pid of the child, -1 on error
+ * Preconditions: plan != NULL, plan->argv != NULL
+ */
+pid_t spawnCommand(struct launchPlan* plan) {
+    assert(plan != NULL && plan->argv != NULL);
+
+    pid_t spawnPID = -1;
+    int result = 0;
+    short flags = 0;
+    char* path = NULL;    //Absolute path from the command cache
+    long long started;    //Start of the spawn for the fork phase of stats
+    long long spawned;    //posix_spawn returned
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t defaults;
+    sigset_t childMask;    //Signal mask of the child
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+
+    if (plan->inFd != -1) { posix_spawn_file_actions_adddup2(&actions, plan->inFd, 0); }
+    if (plan->outFd != -1) { posix_spawn_file_actions_adddup2(&actions, plan->outFd, 1); }
+
+    if (!plan->background) {
+        /* Set up child foreground process to respond to SIGINT */
+        sigemptyset(&defaults);
+        sigaddset(&defaults, SIGINT);
+        posix_spawnattr_setsigdefault(&attr, &defaults);
+        flags |= POSIX_SPAWN_SETSIGDEF;
+    }
+    sigprocmask(SIG_SETMASK, NULL, &childMask);
+    sigdelset(&childMask, SIGCHLD);    //The shell blocks these for its signalfd, children must not inherit that
+    sigdelset(&childMask, SIGINT);
+    sigdelset(&childMask, SIGTSTP);
+    posix_spawnattr_setsigmask(&attr, &childMask);
+    flags |= POSIX_SPAWN_SETSIGMASK;
+    if (plan->pgid != -1) {
+        posix_spawnattr_setpgroup(&attr, plan->pgid);
+        flags |= POSIX_SPAWN_SETPGROUP;
+    }
+#ifdef POSIX_SPAWN_USEVFORK
+    flags |= POSIX_SPAWN_USEVFORK;    //Older glibc only avoids the page-table copy when asked
+#endif
+    posix_spawnattr_setflags(&attr, flags);
+
+    fflush(NULL);    //Flush shell output so it appears before the child's
+    path = lookupCommand(plan->argv[0]);
+    started = statsNow();
+    if (path != NULL) {
+        result = posix_spawn(&spawnPID, path, &actions, &attr, plan->argv, environ);
+        if (result == ENOENT && path != plan->argv[0]) {
+            forgetCommand(plan->argv[0]);    //Cached path disappeared, let posix_spawnp search PATH
+            path = NULL;
+        }
+    }
+    if (path == NULL) {
+        result = posix_spawnp(&spawnPID, plan->argv[0], &actions, &attr, plan->argv, environ);
+    }
+    spawned = statsSince(STATS_FORK, started);    //posix_spawn returns once the child has exec'd, exec is included
+    if (result != 0) {
+        fprintf(stderr, "Exec failure!: %s: %s\n", plan->argv[0], strerror(result));
+        spawnPID = -1;
+    } else if (traceEnabled) {
+        traceLaunch(spawnPID, plan->argv[0], started);
+        traceSpan("fork", started, spawned, spawnPID);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attr);
+    return spawnPID;
+}
+
+/*            forkCommand
+ * Description: This function starts plan with fork and execvp. Kept as a fallback for systems where posix_spawn is not usable. The parent waits for
+ *         EOF on a close-on-exec pipe, which arrives when the child has exec'd or exited, to time the exec phase of stats.
+ * Parameters: struct launchPlan* plan
+ * Returns: pid of the child, -1 on error
+ * Preconditions: plan != NULL, plan->argv != NULL
+ */
+pid_t forkCommand(struct launchPlan* plan) {
+    assert(plan != NULL && plan->argv != NULL);
+
+    pid_t spawnPID = -5;
+    char* path = lookupCommand(plan->argv[0]);    //Resolved in the parent so the cache stays warm
+    int execPipe[2];    //Write end is closed by the child's exec
+    long long started, forked, execed;
+    char c;
+
+    if (pipe2(execPipe, O_CLOEXEC) == -1) { perror("pipe() error\n"); return -1; }
+
+    fflush(NULL);
+    started = statsNow();
+    spawnPID = fork();
+    switch (spawnPID) {
+        case -1: {
+                perror("Error with fork in forkCommand\n");    //Error case
+                close(execPipe[0]);
+                close(execPipe[1]);
+                return -1;
+            }
+
+        case 0: {
+                close(execPipe[0]);
+                if (plan->pgid != -1) { setpgid(0, plan->pgid); }
+
+                sigset_t childMask;
+                shellSignals(&childMask);
+                sigprocmask(SIG_UNBLOCK, &childMask, NULL);    //The shell blocks these for its signalfd
+
+                if (plan->inFd != -1 && dup2(plan->inFd, 0) == -1) {    //Redirect standard input to target given.
+                    perror("dup2 stdin redirection fail!\n");
+                    exit(1);
+                }
+                if (plan->outFd != -1 && dup2(plan->outFd, 1) == -1) {    //Redirect standard output to target given.
+                    perror("dup2 stdout redirection fail!\n");
+                    exit(1);
+                }
+                if (plan->limited && applyModifiers(plan) == -1) {
+                    perror("Launch modifier fail!\n");
+                    exit(1);
+                }
+
+                if (!plan->background) {
+                    /* Set up child foreground process to respond to SIGINT */
+                    struct sigaction SIGINT_action = {0};
+                    SIGINT_action.sa_handler = SIG_DFL;
+                    sigaction(SIGINT, &SIGINT_action, NULL);
+                }
+
+                /* Execute Command, fall back to a PATH search if the cached path is gone */
+                if (path != NULL) { execv(path, plan->argv); }
+                execvp(plan->argv[0], plan->argv);
+                perror("Exec failure!\n");    //If there is a problem with executing command print error and set exit status to 1
+                exit(1);
+            }
+
+        default: {
+                forked = statsSince(STATS_FORK, started);
+                if (plan->pgid != -1) { setpgid(spawnPID, plan->pgid == 0 ? spawnPID : plan->pgid); }    //Set from parent too, avoids a race
+
+                close(execPipe[1]);
+                while (read(execPipe[0], &c, 1) == -1 && errno == EINTR) { }    //EOF once the child has exec'd
+                close(execPipe[0]);
+                execed = statsSince(STATS_EXEC, forked);
+                if (traceEnabled) {
+                    traceLaunch(spawnPID, plan->argv[0], started);
+                    traceSpan("fork", started, forked, spawnPID);
+                    traceSpan("exec-start", forked, execed, spawnPID);
+                }
+                return spawnPID;
+            }
+    }
+}
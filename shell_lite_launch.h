@@ -0,0 +1,66 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_launch.h
+* Description: This is the function declaration file for the launch engine of the shellLite shell. Redirections and the
+*              background operator are resolved in the shell first into a launchPlan, then the command is started with
+*              posix_spawn and file actions so a large shell never pays for fork's page-table copy. Setting
+*              SHELLLITE_LAUNCH=fork in the environment selects the original fork/exec path instead. Leading @ words are
+*              launch modifiers the child applies before exec:
+*                  @cpu=0-3,6    run on these CPUs (sched_setaffinity)
+*                  @cpu=rr       run on the next of the shell's CPUs, successive commands are spread round robin
+*                  @nice=N       niceness N from -20 to 19 (setpriority)
+*                  @mem=SIZE     address space limit above 0, K, M or G suffix (setrlimit RLIMIT_AS)
+*              posix_spawn cannot apply them, commands with modifiers take the fork/exec path.
+* Citations:
+*         1. Brewster, Benjamin "Processes" Assisted with knowledge of getting process ids, using fork(), execvp().
+*         2. posix_spawn(3) Linux manual page, Assisted with file actions and spawn attributes.
+*         3. sched_setaffinity(2), setpriority(2) and setrlimit(2) Linux manual pages, Assisted with the launch modifiers.
+*/
+#ifndef shell_lite_launch_h
+#define shell_lite_launch_h
+
+#include "shell_lite_builtins.h"
+#include <errno.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#define NICE_MIN -20    //Lowest niceness @nice= accepts
+#define NICE_MAX 19     //Highest niceness @nice= accepts
+
+                            /* Struct holding everything needed to start one command */
+struct launchPlan {
+    char** argv;          //Command and arguments with redirections and & removed, NULL terminated
+    int argc;             //Count of argv
+    char* inFile;         //Target of <, NULL if none
+    char* hereText;       //Body of a << here-document or word of a <<< here-string, NULL if none
+    int hereString;       //1 if hereText came from <<<, a newline follows it
+    char* outFile;        //Target of >, NULL if none
+    char** teeFiles;      //Targets of >+, each gets a copy of stdout
+    int teeCount;         //Count of teeFiles
+    int background;       //1 if command runs in the background
+    int inFd;             //Descriptor to use as stdin, -1 to inherit
+    int outFd;            //Descriptor to use as stdout, -1 to inherit
+    pid_t pgid;           //-1 keeps the shell's process group, 0 starts a new one, > 0 joins that group
+    int limited;          //1 if any @ modifier was given
+    int hasCpus;          //1 if cpus holds an @cpu= set
+    cpu_set_t cpus;       //CPUs the command may run on
+    int hasNice;          //1 if niceValue holds an @nice= value
+    int niceValue;        //Niceness of the command
+    rlim_t memLimit;      //@mem= address space limit, RLIM_INFINITY if none
+};
+
+int buildLaunchPlan(char**, int, struct launchPlan*);    //Splits args into modifiers, argv, redirections and background flag
+
+int openLaunchPlan(struct launchPlan*);    //Opens redirection targets in the shell
+
+void closeLaunchPlan(struct launchPlan*);    //Closes descriptors opened for a plan and frees its argv
+
+pid_t launchCommand(struct launchPlan*);    //Starts the command described by a plan, returns its pid or -1
+
+pid_t spawnCommand(struct launchPlan*);    //posix_spawn launch path
+
+pid_t forkCommand(struct launchPlan*);    //fork/exec fallback launch path
+
+#endif /* shell_lite_launch_h */
@@ -0,0 +1,97 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_list.c
+* Description: This is the function implementation file for command lists of the shellLite shell. The whole line is split into
+*              words once by parseBuffer, the list runs over slices of that argument array: every operator is replaced by NULL
+*              so each command's argv ends where the command does, and each command goes through commandHandler, which runs its
+*              $(...) only then.
+* Citations:
+*         1. "Shell Command Language" 2.9.3 Lists, The Open Group Base Specifications Issue 7, Assisted with the list semantics.
+*/
+#include "shell_lite_list.h"
+
+/*            isListOperator
+ * Description: Checks whether args[i] ends a command of a list: ;, && and || always do, & does unless it is the last word of the line.
+ * Parameters: char** args, int i, int count
+ * Returns: 1 if args[i] is a list operator, 0 if not
+ * Preconditions: args != NULL, 0 <= i < count
+ */
+static int isListOperator(char** args, int i, int count) {
+    char* word = args[i];
+    if (word[0] == ';') { return word[1] == '\0'; }
+    if (word[0] == '&' && word[1] == '\0') { return i + 1 < count; }
+    if (word[0] == '&' || word[0] == '|') { return word[1] == word[0] && word[2] == '\0'; }
+    return 0;
+}
+
+/*            findListOperator
+ * Description: This function searches args for the first list operator. parseBuffer makes every operator a word of its own.
+ * Parameters: char** args, int count
+ * Returns: index of the operator, -1 if there is none
+ * Preconditions: args != NULL
+ */
+int findListOperator(char** args, int count) {
+    assert(args != NULL);
+
+    int i;
+    for (i = 0; i < count; i++) {
+        if (isListOperator(args, i, count)) { return i; }
+    }
+    return -1;
+}
+
+/*            listLauncher
+ * Description: This function runs the commands of a list from left to right. A command after && is skipped unless the last foreground command
+ *         exited with 0, a command after || is skipped unless it did not, the skipped command's own operator then decides about the next one.
+ *         A command ended by & runs in the background and the next one starts right away. A trailing ; is allowed, any other empty command
+ *         stops the line with status 1 like a failed launch.
+ * Parameters: char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs
+ * Returns: 1 if exit was run, 0 otherwise
+ * Preconditions: args != NULL, aCount >= 1, lastForeground != NULL, jobs != NULL
+ */
+int listLauncher(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && *aCount >= 1);
+    assert(lastForeground != NULL && jobs != NULL);
+
+    int start = 0;        //First word of the current command
+    int end;              //Index of the operator after it, or count
+    int count;            //Words in the current command
+    int run = 1;          //1 if the current command runs
+    char* op;             //Operator after the current command, NULL for the last one
+    int succeeded;
+    char* saved;          //Word borrowed as the terminator of a background command
+
+    while (start < *aCount) {
+        for (end = start; end < *aCount && !isListOperator(args, end, *aCount); end++) { }
+        op = end < *aCount ? args[end] : NULL;
+
+        if (end == start || (end + 1 == *aCount && op[0] != ';')) {
+            fprintf(stderr, "Error, missing command %s %s\n", end == start ? "before" : "after", op);
+            initProcess(lastForeground);
+            lastForeground->exitValue = 1;
+            return 0;
+        }
+
+        if (run && op != NULL && strcmp(op, "&") == 0) {
+            /* The launchers expect & as the last argument, end the argv after it and give the next word back afterwards */
+            saved = args[end + 1];
+            args[end + 1] = NULL;
+            count = end - start + 1;
+            commandHandler(args + start, &count, lastForeground, jobs);
+            args[end + 1] = saved;
+        } else if (run) {
+            args[end] = NULL;    //End the command's argv at the operator
+            count = end - start;
+            if (commandHandler(args + start, &count, lastForeground, jobs) == 1) { return 1; }
+        }
+
+        if (op == NULL) { break; }
+        succeeded = (lastForeground->signalValue < 0 && lastForeground->exitValue <= 0);    //Before any foreground command status is 0
+        if (strcmp(op, "&&") == 0) { run = succeeded; }
+        else if (strcmp(op, "||") == 0) { run = !succeeded; }
+        else { run = 1; }    //; and &
+        start = end + 1;
+    }
+    return 0;
+}
@@ -0,0 +1,25 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_list.h
+* Description: This is the function declaration file for command lists of the shellLite shell. A line may hold several commands
+*              joined by list operators:
+*                  cmd1 ; cmd2     runs cmd2 after cmd1
+*                  cmd1 && cmd2    runs cmd2 only if cmd1 succeeded
+*                  cmd1 || cmd2    runs cmd2 only if cmd1 failed
+*                  cmd1 & cmd2     runs cmd1 in the background and cmd2 right away
+*              Operators bind left to right with equal precedence, like sh. Success is an exit value of 0 in the status of the
+*              last foreground command, builtins and background commands leave it unchanged.
+* Citations:
+*         1. "Shell Command Language" 2.9.3 Lists, The Open Group Base Specifications Issue 7, Assisted with the list semantics.
+*/
+#ifndef shell_lite_list_h
+#define shell_lite_list_h
+
+#include "shell_lite_builtins.h"
+
+int findListOperator(char**, int);    //Returns the index of the first ;, &&, || or separating & in args, -1 if there is none
+
+int listLauncher(char**, int*, struct process*, struct jobTable*);    //Runs a command list, returns 1 if exit was run
+
+#endif /* shell_lite_list_h */
@@ -0,0 +1,233 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_parallel.c
+* Description: This is the function implementation file for the parallel builtin of the shellLite shell. Commands are started
+*              through the launch engine and tracked in the job table like any other child, so finished commands are noticed
+*              through the same SIGCHLD signalfd and their slot is refilled right away.
+* Citations:
+*         1. Tange, Ole "GNU Parallel" man page, Assisted with the command line syntax and exit status convention.
+*/
+#include "shell_lite_parallel.h"
+#include "shell_lite_launch.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_input.h"
+#include "shell_lite_heredoc.h"
+#include <errno.h>
+
+                            /* Struct describing where parallel gets its commands from */
+struct jobSource {
+    char** templateArgs;         //Command and fixed arguments in ::: mode
+    int templateCount;           //Count of templateArgs
+    char** values;               //Arguments after :::, one command per value
+    int valueCount;              //Count of values
+    int next;                    //Index of the next value
+    struct lineReader* reader;   //Command file in < mode, NULL in ::: mode
+    char pid[50];                //Shell pid for $$ expansion of command file lines
+};
+
+/*            nextCommand
+ * Description: Builds the next command of src in jobArena. Blank lines and comments in a command file are skipped.
+ * Parameters: struct jobSource* src, struct arena* jobArena, int* count
+ * Returns: NULL terminated argument array, or NULL when src is exhausted
+ * Preconditions: src != NULL, jobArena != NULL, count != NULL
+ */
+static char** nextCommand(struct jobSource* src, struct arena* jobArena, int* count) {
+    char** args;
+    char* line;
+    ssize_t length;
+
+    if (src->reader == NULL) {
+        if (src->next >= src->valueCount) { return NULL; }
+        args = arenaAlloc(jobArena, (src->templateCount + 2) * sizeof(char*));
+        memcpy(args, src->templateArgs, src->templateCount * sizeof(char*));
+        args[src->templateCount] = src->values[src->next++];
+        args[src->templateCount + 1] = NULL;
+        *count = src->templateCount + 1;
+        return args;
+    }
+
+    while ((length = readLine(src->reader, &line)) != 0) {
+        if (length == -1) {
+            if (errno == EINTR) { continue; }
+            return NULL;
+        }
+        if (line[0] == '#') { continue; }
+        args = parseBuffer(line, length, src->pid, count, 1, jobArena, NULL);    //No $(...), commands run N at a time
+        if (*count > 0) {
+            readHereDocuments(args, *count, src->reader, src->pid, 0, jobArena);    //Bodies follow in the file like in a script
+            return args;
+        }
+    }
+    return NULL;
+}
+
+/*            launchJob
+ * Description: Starts one command of the parallel run. stdout is shared with the shell, stdin is /dev/null unless the command redirects it.
+ * Parameters: char** args, int count
+ * Returns: pid of the command, -1 if it could not be started
+ * Preconditions: args != NULL, count >= 1
+ */
+static pid_t launchJob(char** args, int count) {
+    struct launchPlan plan;
+    pid_t pid = -1;
+
+    if (buildLaunchPlan(args, count, &plan) == -1) { return -1; }
+    if (plan.teeCount > 0) {
+        fprintf(stderr, "Error, >+ is not supported by parallel\n");
+        closeLaunchPlan(&plan);
+        return -1;
+    }
+    if (plan.inFile == NULL && plan.hereText == NULL) {
+        plan.inFd = open("/dev/null", O_RDONLY | O_CLOEXEC);    //Commands must not read the shell's input
+    }
+    if (openLaunchPlan(&plan) == 0) {
+        pid = launchCommand(&plan);
+    }
+    closeLaunchPlan(&plan);
+    return pid;
+}
+
+/*            parallelCommand
+ * Description: This function runs the parallel builtin. At most N commands run at once, every reaped command frees its slot for the next one.
+ *         N is capped at PARALLEL_JOBS_PER_CPU per online CPU and at RLIMIT_NPROC before the slots are allocated. After a SIGINT no command is
+ *         started, the running ones are waited for. When all commands are done a summary is printed and lastForeground records the number of
+ *         failed commands as its exit value.
+ * Parameters: char** args, int count, struct process* lastForeground, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, count >= 1, lastForeground != NULL, jobs != NULL
+ */
+void parallelCommand(char** args, int count, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && count >= 1 && lastForeground != NULL && jobs != NULL);
+
+    int i;                      //index
+    int first = 1;              //First argument after the options
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long limit = cpus;          //Max commands in flight
+    long cap;                   //Largest limit -j may ask for
+    char* end;
+    struct rlimit procLimit;
+    int running = 0;            //Commands in flight
+    int started = 0;            //Commands started or failed to start
+    int failed = 0;             //Commands that did not exit with 0
+    int exhausted = 0;          //1 once the source has no more commands
+    int cmdCount = 0;
+    char** cmdArgs;
+    struct jobSource src;
+    struct lineReader reader;
+    struct arena jobArena;      //Holds the arguments of the command being started
+    int fileFd = -1;
+    struct rusage total;        //Resource usage of every command, reported by the time prefix
+    struct timespec begun;      //Start of the run
+
+    if (cpus < 1) { cpus = limit = 1; }
+    if (count > 2 && strcmp(args[1], "-j") == 0) {
+        errno = 0;
+        limit = strtol(args[2], &end, 10);
+        if (errno != 0 || end == args[2] || *end != '\0' || limit < 1) {
+            fprintf(stderr, "parallel: -j needs a positive number, not %s\n", args[2]);
+            return;
+        }
+        first = 3;
+    }
+
+    /* The slots are allocated up front, more commands than the system lets the user run could only fail to fork */
+    cap = cpus * PARALLEL_JOBS_PER_CPU;
+    if (getrlimit(RLIMIT_NPROC, &procLimit) == 0 && procLimit.rlim_cur != RLIM_INFINITY && procLimit.rlim_cur < (rlim_t)cap) {
+        cap = procLimit.rlim_cur > 0 ? (long)procLimit.rlim_cur : 1;
+    }
+    if (limit > cap) {
+        fprintf(stderr, "parallel: -j %ld lowered to %ld\n", limit, cap);
+        limit = cap;
+    }
+
+    /* Work out where the commands come from */
+    memset(&src, 0, sizeof(src));
+    sprintf(src.pid, "%d", (int)getpid());
+    for (i = first; i < count && strcmp(args[i], ":::") != 0; i++) { }
+    if (i < count) {
+        src.templateArgs = args + first;
+        src.templateCount = i - first;
+        src.values = args + i + 1;
+        src.valueCount = count - i - 1;
+        if (src.templateCount == 0) {
+            fprintf(stderr, "parallel: missing command before :::\n");
+            return;
+        }
+    } else if (count - first == 2 && strcmp(args[first], "<") == 0) {
+        fileFd = open(args[first + 1], O_RDONLY | O_CLOEXEC);
+        if (fileFd == -1) { perror("open() error\n"); return; }
+        initLineReader(&reader, fileFd);
+        src.reader = &reader;
+    } else {
+        fprintf(stderr, "Usage: parallel [-j N] command [args...] ::: arg...\n       parallel [-j N] < file\n");
+        return;
+    }
+
+    struct process* slots = malloc(limit * sizeof(struct process));
+    assert(slots != NULL);
+    for (i = 0; i < limit; i++) {
+        initProcess(&slots[i]);
+    }
+    initArena(&jobArena, ARENA_START_SIZE);
+    memset(&total, 0, sizeof(total));
+    clock_gettime(CLOCK_MONOTONIC, &begun);
+
+    jobs->interrupted = 0;
+    while ((!exhausted && !jobs->interrupted) || running > 0) {
+        /* Fill every free slot, none after a SIGINT: the running commands got it too and are only waited for */
+        for (i = 0; i < limit && !exhausted && !jobs->interrupted; i++) {
+            if (slots[i].pid > 0) { continue; }
+            arenaReset(&jobArena);
+            cmdArgs = nextCommand(&src, &jobArena, &cmdCount);
+            if (cmdArgs == NULL) { exhausted = 1; break; }
+
+            started++;
+            initProcess(&slots[i]);
+            slots[i].pid = launchJob(cmdArgs, cmdCount);
+            if (slots[i].pid == -1) {
+                slots[i].pid = 0;
+                failed++;
+                continue;
+            }
+            trackProcess(jobs, &slots[i]);
+            running++;
+        }
+        if (running == 0) { continue; }
+
+        /* Wait for at least one command to change state, then collect every finished one. The commands share the shell's group,
+         * one stopped by CTRL-Z or SIGSTOP is continued like waitForCommand does, the run would never finish otherwise */
+        waitForChildEvent(jobs);
+        for (i = 0; i < limit; i++) {
+            if (slots[i].pid > 0 && slots[i].stopped) {
+                slots[i].stopped = 0;    //Set again if it stops before it finishes
+                kill(slots[i].pid, SIGCONT);
+            }
+            if (slots[i].pid > 0 && slots[i].done) {
+                if (slots[i].exitValue != 0) { failed++; }
+                addUsage(&total, &slots[i].usage);
+                slots[i].pid = 0;
+                running--;
+            }
+        }
+    }
+
+    if (jobs->interrupted && !exhausted) {
+        printf("parallel: interrupted, remaining commands not started\n");
+    }
+    printf("parallel: %d commands, %d succeeded, %d failed\n", started, started - failed, failed);
+
+    initProcess(lastForeground);
+    lastForeground->exitValue = failed < PARALLEL_MAX_FAILED ? failed : PARALLEL_MAX_FAILED;
+    lastForeground->done = 1;
+    lastForeground->start = begun;
+    lastForeground->usage = total;
+    clock_gettime(CLOCK_MONOTONIC, &lastForeground->end);
+
+    freeArena(&jobArena);
+    free(slots);
+    if (fileFd != -1) {
+        freeLineReader(&reader);
+        close(fileFd);
+    }
+}
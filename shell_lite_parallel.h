@@ -0,0 +1,25 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_parallel.h
+* Description: This is the function declaration file for the parallel builtin of the shellLite shell. parallel runs a list of
+*              commands with at most N in flight, starting the next one as soon as any running one exits:
+*                  parallel [-j N] command [args...] ::: arg1 arg2 ...    runs command args argK for every argK
+*                  parallel [-j N] < file                                 runs every line of file as a command
+*              N defaults to the number of online CPUs and is capped at PARALLEL_JOBS_PER_CPU per CPU and at RLIMIT_NPROC. After
+*              a SIGINT no more commands are started, the running ones are waited for. A summary is printed at the end and status reports the number of failed
+*              commands (capped at 101, like GNU parallel).
+* Citations:
+*         1. Tange, Ole "GNU Parallel" man page, Assisted with the command line syntax and exit status convention.
+*/
+#ifndef shell_lite_parallel_h
+#define shell_lite_parallel_h
+
+#include "shell_lite_builtins.h"
+
+#define PARALLEL_MAX_FAILED 101    //Largest exit value reported for failed commands
+#define PARALLEL_JOBS_PER_CPU 16   //-j is capped at this many commands per online CPU
+
+void parallelCommand(char**, int, struct process*, struct jobTable*);    //Runs the parallel builtin
+
+#endif /* shell_lite_parallel_h */
@@ -0,0 +1,309 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_pipeline.c
+* Description: This is the function implementation file for the | operator of the shellLite shell. Every stage of a
+*              pipeline is started by the launch engine, connected to its neighbours with pipe(2) and placed in the process
+*              group of the first stage. status reports the last stage of the most recent foreground pipeline.
+* Citations:
+*         1. Brewster, Benjamin "More UNIX I/O" Assisted with I/O redirection
+*         2. splice(2) Linux manual page, Assisted with zero-copy relaying between pipes.
+*/
+#include "shell_lite_pipeline.h"
+#include "shell_lite_launch.h"
+#include "shell_lite_jobs.h"
+
+/*            spliceRelay
+ * Description: This function moves data from fromFds[k] to toFds[k] for every boundary k with splice(2), so the bytes never enter
+ *         user space. Each boundary is either waiting for input or waiting for room in its output pipe, which keeps the poll loop
+ *         from spinning. The job table's signalfd is polled as well, so CTRL-C reaches the pipeline while the shell relays.
+ *         Stages that stop are continued. Descriptors are closed as each boundary finishes, all of them if poll fails. Returns a dynamically allocated array of bytes moved per boundary.
+ * Parameters: int* fromFds, int* toFds, int count, struct jobTable* jobs
+ * Returns: long long* bytes moved per boundary
+ * Preconditions: fromFds != NULL, toFds != NULL, count > 0, jobs != NULL
+ */
+long long* spliceRelay(int* fromFds, int* toFds, int count, struct jobTable* jobs) {
+    assert(fromFds != NULL && toFds != NULL && count > 0 && jobs != NULL);
+
+    int i;
+    int active = count;        //Number of boundaries still moving data
+    ssize_t moved = 0;
+    long long* bytes = malloc(count * sizeof(long long));
+    int* waitingOutput = malloc(count * sizeof(int));    //1 if boundary is waiting on room in its output pipe
+    struct pollfd* fds = malloc((count + 1) * sizeof(struct pollfd));    //Last entry is the signalfd
+    assert(bytes != NULL && waitingOutput != NULL && fds != NULL);
+
+    for (i = 0; i < count; i++) {
+        bytes[i] = 0;
+        waitingOutput[i] = 0;
+    }
+
+    while (active > 0) {
+        /* Build poll set, finished boundaries are skipped with fd -1 */
+        for (i = 0; i < count; i++) {
+            fds[i].fd = (fromFds[i] == -1) ? -1 : (waitingOutput[i] ? toFds[i] : fromFds[i]);
+            fds[i].events = waitingOutput[i] ? POLLOUT : POLLIN;
+            fds[i].revents = 0;
+        }
+        fds[count].fd = jobs->sigFd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+
+        if (poll(fds, count + 1, -1) == -1) {
+            if (errno == EINTR) { continue; }
+            perror("poll() error in spliceRelay\n");
+
+            /* Give up on every boundary, the stages only see EOF once the shell's ends are closed */
+            for (i = 0; i < count; i++) {
+                if (fromFds[i] != -1) { close(fromFds[i]); fromFds[i] = -1; }
+                if (toFds[i] != -1) { close(toFds[i]); toFds[i] = -1; }
+            }
+            break;
+        }
+        if (fds[count].revents != 0) {
+            reapChildren(jobs);    //Forwards SIGINT, stages that exit early are reaped here
+            if (jobs->foregroundPgid > 0) {
+                kill(-jobs->foregroundPgid, SIGCONT);    //A stage stopped by CTRL-Z would stall the relay, keep every stage running
+            }
+        }
+
+        for (i = 0; i < count; i++) {
+            if (fds[i].fd == -1 || fds[i].revents == 0) { continue; }
+
+            waitingOutput[i] = 0;
+            moved = splice(fromFds[i], NULL, toFds[i], NULL, PIPE_RELAY_CHUNK, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+            if (moved > 0) {
+                bytes[i] += moved;    //Count data moved across this boundary
+            } else if (moved == -1 && errno == EAGAIN) {
+                /* Either side may be the cause, wait for room downstream before trying again */
+                waitingOutput[i] = 1;
+            } else {
+                /* End of data or downstream closed its input, finish boundary so both neighbours see EOF */
+                close(fromFds[i]); fromFds[i] = -1;
+                close(toFds[i]); toFds[i] = -1;
+                active--;
+            }
+        }
+    }
+
+    free(waitingOutput);
+    free(fds);
+    return bytes;
+}
+
+/*            pipelineLauncher
+ * Description: This function launches commands joined by the | operator. Each stage is launched and connected to the next with a pipe.
+ *         < is honored on the first stage and > on the last. All stages share the process group of the first stage. Foreground pipelines
+ *         get the terminal and are waited on, lastForeground is updated with the last stage. A foreground pipeline stopped by CTRL-Z becomes a
+ *         job, background pipelines have every stage added to the job table. A pipe that cannot be created fails the line, not the shell.
+ * Parameters: char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs
+ * Returns: void
+ * Preconditions: args != NULL, aCount >= 1, lastForeground != NULL, jobs != NULL
+ */
+void pipelineLauncher(char** args, int* aCount, struct process* lastForeground, struct jobTable* jobs) {
+    assert(args != NULL && *aCount >= 1);
+    assert(lastForeground != NULL && jobs != NULL);
+
+    int i, j;                //index
+    int count = *aCount;     //Count of args without the background operator
+    int background = 0;      //1 if pipeline runs in the background
+    int relay = 0;           //1 if the shell relays data between stages with splice
+    int stages = 1;          //Number of stages in the pipeline
+    int terminal = 0;        //1 while a foreground pipeline's group owns the terminal
+    int stoppedJob = 0;      //Job number of a foreground pipeline that was stopped
+    pid_t pgid = 0;          //Process group of the pipeline, pid of the first stage
+    struct timespec launched;    //Start of the pipeline for the time prefix
+
+    if (strcmp(args[count - 1], "&") == 0) {
+        background = 1;
+        count--;
+    }
+    relay = (background == 0 && getenv("SHELLLITE_SPLICE") != NULL);    //Relay mode needs the shell present for the whole pipeline
+
+    /* Find the start of every stage, replace each | by NULL to end the previous stage's argv */
+    for (i = 0; i < count; i++) {
+        if (strcmp(args[i], "|") == 0) { stages++; }
+    }
+    int* starts = malloc(stages * sizeof(int));
+    int* ends = malloc(stages * sizeof(int));
+    char** stageArgs = malloc((count + 1) * sizeof(char*));    //Copy of args pointers, | replaced by NULL
+    pid_t* pids = malloc(stages * sizeof(pid_t));
+    int* readFds = malloc(stages * sizeof(int));     //stdin of each stage, -1 means inherit
+    int* writeFds = malloc(stages * sizeof(int));    //stdout of each stage, -1 means inherit
+    int* relayFrom = malloc(stages * sizeof(int));   //Shell side read end of each boundary in relay mode
+    int* relayTo = malloc(stages * sizeof(int));     //Shell side write end of each boundary in relay mode
+    assert(starts != NULL && ends != NULL && stageArgs != NULL && pids != NULL);
+    assert(readFds != NULL && writeFds != NULL && relayFrom != NULL && relayTo != NULL);
+
+    j = 0;
+    starts[0] = 0;
+    for (i = 0; i < count; i++) {
+        if (strcmp(args[i], "|") == 0) {
+            stageArgs[i] = NULL;
+            ends[j] = i;
+            starts[++j] = i + 1;
+        } else {
+            stageArgs[i] = args[i];
+        }
+    }
+    stageArgs[count] = NULL;
+    ends[j] = count;
+
+    for (i = 0; i < stages; i++) {
+        if (starts[i] == ends[i]) {
+            fprintf(stderr, "Error, missing command in pipeline\n");
+            initProcess(lastForeground);
+            lastForeground->exitValue = 1;
+            free(starts); free(ends); free(stageArgs); free(pids);
+            free(readFds); free(writeFds); free(relayFrom); free(relayTo);
+            return;
+        }
+        readFds[i] = -1;
+        writeFds[i] = -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &launched);
+
+    /* Connect each boundary, in relay mode the shell holds the middle of two pipes */
+    for (i = 0; i < stages - 1; i++) {
+        int first[2], second[2];
+        if (pipe2(first, O_CLOEXEC) == -1) { perror("pipe() error\n"); break; }
+        writeFds[i] = first[1];
+        if (relay) {
+            if (pipe2(second, O_CLOEXEC) == -1) {
+                perror("pipe() error\n");
+                close(first[0]);    //first[1] is closed with writeFds below
+                break;
+            }
+            relayFrom[i] = first[0];
+            relayTo[i] = second[1];
+            readFds[i + 1] = second[0];
+        } else {
+            readFds[i + 1] = first[0];
+        }
+    }
+    if (i < stages - 1) {
+        /* Out of descriptors, close the boundaries already connected and run nothing */
+        for (j = 0; j < stages; j++) {
+            if (readFds[j] != -1) { close(readFds[j]); }
+            if (writeFds[j] != -1) { close(writeFds[j]); }
+            if (relay && j < i) { close(relayFrom[j]); close(relayTo[j]); }
+        }
+        initProcess(lastForeground);
+        lastForeground->exitValue = 1;
+        free(starts); free(ends); free(stageArgs); free(pids);
+        free(readFds); free(writeFds); free(relayFrom); free(relayTo);
+        return;
+    }
+
+    /* Launch one child per stage, each stage owns its pipe ends through its launchPlan */
+    for (i = 0; i < stages; i++) {
+        struct launchPlan plan;
+        pids[i] = -1;
+
+        if (buildLaunchPlan(stageArgs + starts[i], ends[i] - starts[i], &plan) == 0) {
+            if ((plan.inFile != NULL || plan.hereText != NULL) && i != 0) {
+                fprintf(stderr, "Error, <, << and <<< are only supported on the first stage of a pipeline\n");
+            } else if (plan.outFile != NULL && i != stages - 1) {
+                fprintf(stderr, "Error, > is only supported on the last stage of a pipeline\n");
+            } else if (plan.teeCount > 0) {
+                fprintf(stderr, "Error, >+ is not supported in a pipeline\n");
+            } else {
+                plan.inFd = readFds[i]; readFds[i] = -1;    //Plan now owns the pipe ends
+                plan.outFd = writeFds[i]; writeFds[i] = -1;
+                plan.background = background;
+                plan.pgid = pgid;    //0 for the first stage creates the group
+                if (openLaunchPlan(&plan) == 0) {
+                    pids[i] = launchCommand(&plan);
+                    if (pgid == 0 && pids[i] > 0) {
+                        pgid = pids[i];    //Later stages join the first stage's group
+                        if (!background && (terminal = giveTerminal(pgid))) {
+                            kill(-pgid, SIGCONT);    //Resumes a first stage that read the terminal before the handoff and got SIGTTIN
+                        }
+                    }
+                }
+            }
+            closeLaunchPlan(&plan);
+        }
+    }
+
+    /* Parent keeps only the relay ends */
+    for (i = 0; i < stages; i++) {
+        if (readFds[i] != -1) { close(readFds[i]); }
+        if (writeFds[i] != -1) { close(writeFds[i]); }
+    }
+
+    if (background) {
+        for (i = 0; i < stages; i++) {
+            if (pids[i] == -1) { continue; }    //Stage failed to launch
+            printf("Background pid is %d!\n", pids[i]);
+
+            addJob(jobs, pids[i], pgid);    //Add every stage to the job table so each one is reaped, the stages form one job
+        }
+    } else {
+        struct sigaction pipe_action = {0}, old_pipe = {0};
+
+        /* Track every stage before relaying so stages that finish early are reaped, status reports the last one */
+        struct process* stageProcs = malloc(stages * sizeof(struct process));
+        assert(stageProcs != NULL);
+        for (i = 0; i < stages; i++) {
+            initProcess(&stageProcs[i]);
+            stageProcs[i].pid = pids[i];
+            if (pids[i] != -1) { trackProcess(jobs, &stageProcs[i]); }
+        }
+        jobs->foregroundPgid = pgid;    //The pipeline has its own group, reapChildren forwards CTRL-C to it when it does not own the terminal
+
+        if (relay) {
+            /* Ignore SIGPIPE in the shell while relaying, a stage exiting early surfaces as EPIPE instead */
+            pipe_action.sa_handler = SIG_IGN;
+            sigaction(SIGPIPE, &pipe_action, &old_pipe);
+
+            long long* bytes = spliceRelay(relayFrom, relayTo, stages - 1, jobs);
+            sigaction(SIGPIPE, &old_pipe, NULL);
+
+            for (i = 0; i < stages - 1; i++) {
+                fprintf(stderr, "stage %d (%s): %lld bytes\n", i + 1, stageArgs[starts[i]], bytes[i]);
+            }
+            free(bytes);
+        }
+
+        /* CTRL-Z stops the whole group, each wait then returns. The relay needs every stage running, its stages are continued instead */
+        for (i = 0; i < stages; i++) {
+            if (pids[i] == -1) { continue; }
+            if (relay) { waitForCommand(jobs, &stageProcs[i]); }
+            else { waitForProcess(jobs, &stageProcs[i]); }
+        }
+        if (terminal) { reclaimTerminal(); }
+        if (pgid > 0) { stoppedJob = stopForeground(jobs, stageProcs, stages, pgid); }
+
+        if (stoppedJob > 0) {
+            printf("[%d] Stopped\n", stoppedJob);    //Like fg, status keeps reporting the previous foreground command
+        } else if (pids[stages - 1] == -1) {
+            initProcess(lastForeground);    //reset lastForeground's variables
+            lastForeground->exitValue = 1;    //Last stage failed to launch
+        } else {
+            *lastForeground = stageProcs[stages - 1];
+            lastForeground->next = NULL;
+            lastForeground->start = launched;
+
+            /* The time prefix reports the whole pipeline, ending when its last stage was reaped */
+            for (i = 0; i < stages - 1; i++) {
+                if (pids[i] == -1) { continue; }
+                addUsage(&lastForeground->usage, &stageProcs[i].usage);
+                if (stageProcs[i].end.tv_sec > lastForeground->end.tv_sec ||
+                    (stageProcs[i].end.tv_sec == lastForeground->end.tv_sec && stageProcs[i].end.tv_nsec > lastForeground->end.tv_nsec)) {
+                    lastForeground->end = stageProcs[i].end;
+                }
+            }
+            if (lastForeground->signalValue >= 0) {
+                status(lastForeground);    //Print signal that terminated the pipeline
+            }
+        }
+        free(stageProcs);
+        jobs->foregroundPgid = 0;
+    }
+
+    free(starts); free(ends); free(stageArgs); free(pids);
+    free(readFds); free(writeFds); free(relayFrom); free(relayTo);
+}
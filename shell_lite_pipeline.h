@@ -0,0 +1,27 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_pipeline.h
+* Description: This is the function declaration file for the | operator of the shellLite shell. A command line such as
+*              cmd1 | cmd2 | cmd3 forks one child per stage, wires the stages together with pipe(2) and places every
+*              stage in one process group. Setting SHELLLITE_SPLICE in the environment makes the shell relay the data
+*              between stages itself with splice(2) and report the number of bytes moved by each stage.
+* Citations:
+*         1. Brewster, Benjamin "More UNIX I/O" Assisted with I/O redirection
+*         2. splice(2) Linux manual page, Assisted with zero-copy relaying between pipes.
+*/
+#ifndef shell_lite_pipeline_h
+#define shell_lite_pipeline_h
+
+#include "shell_lite_builtins.h"
+#include <errno.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+#define PIPE_RELAY_CHUNK 65536    //Max bytes moved by a single splice call in relay mode
+
+void pipelineLauncher(char**, int*, struct process*, struct jobTable*);    //Launches commands joined by the | operator
+
+long long* spliceRelay(int*, int*, int, struct jobTable*);    //Moves data between stages with splice until every stage has closed its output
+
+#endif /* shell_lite_pipeline_h */
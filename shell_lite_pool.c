@@ -0,0 +1,304 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_pool.c
+* Description: This is the function implementation file for the helper pool of the shellLite shell. Control sockets are
+*              SOCK_SEQPACKET pairs so one sendmsg carries a whole request. The shell keeps its socket end until the helper has
+*              exec'd: EOF means the command is running, an errno value means the exec failed.
+* Citations:
+*         1. unix(7) and cmsg(3) Linux manual pages, Assisted with passing file descriptors over a socket.
+*/
+#include "shell_lite_pool.h"
+#include "shell_lite_hash.h"
+#include "shell_lite_jobs.h"
+
+                            /* Struct sent ahead of the argv of every request */
+struct poolRequest {
+    int background;    //1 for background commands, SIGINT stays ignored
+    pid_t pgid;        //Same meaning as launchPlan's pgid
+    int hasIn;         //1 if a stdin descriptor is attached
+    int hasOut;        //1 if a stdout descriptor is attached
+    int argc;          //Number of argv strings after the path
+};
+
+static int poolTarget = 0;               //Number of helpers to keep, 0 when the pool is off
+static int poolCount = 0;                //Number of idle helpers
+static int poolSockets[POOL_MAX];        //Shell end of each idle helper's control socket
+static pid_t poolPids[POOL_MAX];         //pid of each idle helper
+static char* message = NULL;             //Request body: path then argv, each null terminated
+
+/*            helperMain
+ * Description: Body of a helper. Blocks for one request, then becomes the command. Exits quietly when the shell closes the socket.
+ * Parameters: int sock
+ * Returns: never, the helper exits or execs
+ * Preconditions: sock is the helper end of a control socket
+ */
+__attribute__((noreturn)) static void helperMain(int sock) {
+    struct poolRequest request;
+    struct iovec iov[2];
+    struct msghdr msg;
+    struct cmsghdr* cmsg;
+    union { char buffer[CMSG_SPACE(2 * sizeof(int))]; struct cmsghdr align; } control;
+    char* data = malloc(POOL_MESSAGE_MAX + 1);
+    char** argv;
+    char* next;
+    int fds[2] = { -1, -1 };
+    int fdCount = 0;
+    int i, err;
+    ssize_t received;
+    sigset_t childMask;
+    struct sigaction action = {0};
+
+    if (data == NULL) { _exit(1); }
+
+    /* Idle helpers sit in the shell's process group, discard the CTRL-C and CTRL-Z they collect while the signals are blocked */
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTSTP, &action, NULL);
+    memset(&msg, 0, sizeof(msg));
+    iov[0].iov_base = &request;
+    iov[0].iov_len = sizeof(request);
+    iov[1].iov_base = data;
+    iov[1].iov_len = POOL_MESSAGE_MAX;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    do {
+        received = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);    //Received descriptors only reach the command through dup2
+    } while (received == -1 && errno == EINTR);
+    if (received < (ssize_t)sizeof(request)) { _exit(0); }    //Shell retired this helper
+    data[received - sizeof(request)] = '\0';
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            fdCount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            memcpy(fds, CMSG_DATA(cmsg), fdCount * sizeof(int));
+        }
+    }
+
+    /* path, then argc arguments */
+    argv = malloc((request.argc + 1) * sizeof(char*));
+    if (argv == NULL) { _exit(1); }
+    next = data + strlen(data) + 1;
+    for (i = 0; i < request.argc; i++) {
+        argv[i] = next;
+        next += strlen(next) + 1;
+    }
+    argv[request.argc] = NULL;
+
+    if (request.pgid != -1) { setpgid(0, request.pgid); }
+    if (request.hasIn && dup2(fds[0], 0) == -1) { err = errno; goto failed; }
+    if (request.hasOut && dup2(fds[request.hasIn], 1) == -1) { err = errno; goto failed; }
+
+    if (!request.background) {
+        /* Set up child foreground process to respond to SIGINT */
+        action.sa_handler = SIG_DFL;
+        sigaction(SIGINT, &action, NULL);
+    }
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGTSTP, &action, NULL);
+    shellSignals(&childMask);
+    sigprocmask(SIG_UNBLOCK, &childMask, NULL);    //The shell blocks these for its signalfd
+
+    if (data[0] != '\0') { execv(data, argv); }
+    execvp(argv[0], argv);
+    err = errno;
+
+failed:
+    write(sock, &err, sizeof(err));    //Reported by the shell
+    _exit(1);
+}
+
+/*            forkHelper
+ * Description: Forks one helper and pushes it on the idle stack.
+ * Parameters: void
+ * Returns: 0 on success, -1 on error
+ * Preconditions: poolCount < POOL_MAX
+ */
+static int forkHelper(void) {
+    int pair[2];
+    int i;
+    pid_t pid;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, pair) == -1) {
+        perror("socketpair() error\n");
+        return -1;
+    }
+
+    pid = fork();
+    switch (pid) {
+        case -1: {
+                perror("Error with fork in forkHelper\n");
+                close(pair[0]);
+                close(pair[1]);
+                return -1;
+            }
+
+        case 0: {
+                /* Drop the shell ends of the other helpers, or they would not see EOF when the shell retires them */
+                for (i = 0; i < poolCount; i++) {
+                    close(poolSockets[i]);
+                }
+                close(pair[0]);
+                helperMain(pair[1]);
+            }
+
+        default: {
+                close(pair[1]);
+                poolSockets[poolCount] = pair[0];
+                poolPids[poolCount] = pid;
+                poolCount++;
+                return 0;
+            }
+    }
+}
+
+/*            initPool
+ * Description: This function reads the pool size from SHELLLITE_POOL and forks the helpers. Without it the pool stays off.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: Called once, after the job table has blocked SIGCHLD
+ */
+void initPool(void) {
+    char* setting = getenv("SHELLLITE_POOL");
+    if (setting == NULL) { return; }
+
+    poolTarget = atoi(setting);
+    if (poolTarget < 0) { poolTarget = 0; }
+    if (poolTarget > POOL_MAX) { poolTarget = POOL_MAX; }
+    if (poolTarget == 0) { return; }
+
+    message = malloc(POOL_MESSAGE_MAX);
+    assert(message != NULL);
+    refillPool();
+}
+
+/*            refillPool
+ * Description: This function forks helpers until the pool holds SHELLLITE_POOL of them. Called at the prompt so the forks stay off the launch path.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void refillPool(void) {
+    while (poolCount < poolTarget) {
+        if (forkHelper() == -1) { return; }
+    }
+}
+
+/*            resetPool
+ * Description: This function closes the control socket of every idle helper, each one exits when it sees EOF and is reaped as an unknown child.
+ *         Helpers copy the shell's cwd when they are forked, so cd retires them and the next prompt forks fresh ones.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void resetPool(void) {
+    while (poolCount > 0) {
+        poolCount--;
+        close(poolSockets[poolCount]);
+    }
+}
+
+/*            freePool
+ * Description: This function retires every helper and turns the pool off.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void freePool(void) {
+    resetPool();
+    poolTarget = 0;
+    free(message);
+    message = NULL;
+}
+
+/*            poolLaunch
+ * Description: This function hands plan to an idle helper and waits until the helper has exec'd. The path comes from the command cache so the
+ *         helper does not search PATH. A helper that died while idle is skipped.
+ * Parameters: struct launchPlan* plan
+ * Returns: pid of the command, -1 if exec failed, POOL_UNAVAILABLE if no helper is idle or argv is too long for a request
+ * Preconditions: plan != NULL, plan->argv != NULL
+ */
+pid_t poolLaunch(struct launchPlan* plan) {
+    assert(plan != NULL && plan->argv != NULL);
+
+    struct poolRequest request;
+    struct iovec iov[2];
+    struct msghdr msg;
+    struct cmsghdr* cmsg;
+    union { char buffer[CMSG_SPACE(2 * sizeof(int))]; struct cmsghdr align; } control;
+    char* path;
+    size_t length = 0;
+    size_t size;
+    int fds[2];
+    int fdCount = 0;
+    int sock, err, i;
+    ssize_t result;
+    pid_t pid;
+
+    if (poolCount == 0) { return POOL_UNAVAILABLE; }
+
+    /* Pack path and argv */
+    path = lookupCommand(plan->argv[0]);
+    if (path == NULL) { path = ""; }
+    for (i = -1; i < plan->argc; i++) {
+        char* text = i == -1 ? path : plan->argv[i];
+        size = strlen(text) + 1;
+        if (length + size > POOL_MESSAGE_MAX) { return POOL_UNAVAILABLE; }
+        memcpy(message + length, text, size);
+        length += size;
+    }
+
+    request.background = plan->background;
+    request.pgid = plan->pgid;
+    request.hasIn = plan->inFd != -1;
+    request.hasOut = plan->outFd != -1;
+    request.argc = plan->argc;
+    if (request.hasIn) { fds[fdCount++] = plan->inFd; }
+    if (request.hasOut) { fds[fdCount++] = plan->outFd; }
+
+    memset(&msg, 0, sizeof(msg));
+    iov[0].iov_base = &request;
+    iov[0].iov_len = sizeof(request);
+    iov[1].iov_base = message;
+    iov[1].iov_len = length;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    if (fdCount > 0) {
+        memset(&control, 0, sizeof(control));
+        msg.msg_control = control.buffer;
+        msg.msg_controllen = CMSG_SPACE(fdCount * sizeof(int));
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(fdCount * sizeof(int));
+        memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(int));
+    }
+
+    fflush(NULL);    //Flush shell output so it appears before the command's
+
+    /* Take helpers off the stack until one accepts the request */
+    while (1) {
+        if (poolCount == 0) { return POOL_UNAVAILABLE; }
+        poolCount--;
+        sock = poolSockets[poolCount];
+        pid = poolPids[poolCount];
+        if (sendmsg(sock, &msg, MSG_NOSIGNAL) != -1) { break; }
+        close(sock);    //Helper is gone, it is reaped as an unknown child
+    }
+
+    if (plan->pgid != -1) { setpgid(pid, plan->pgid == 0 ? pid : plan->pgid); }    //Set from the shell too, like forkCommand
+
+    do {
+        result = read(sock, &err, sizeof(err));    //EOF once the helper has exec'd
+    } while (result == -1 && errno == EINTR);
+    close(sock);
+
+    if (result == sizeof(err)) {
+        fprintf(stderr, "Exec failure!: %s: %s\n", plan->argv[0], strerror(err));
+        return -1;
+    }
+    return pid;
+}
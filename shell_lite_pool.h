@@ -0,0 +1,34 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_pool.h
+* Description: This is the function declaration file for the helper pool of the shellLite shell. With SHELLLITE_POOL=N in the
+*              environment the shell keeps N pre-forked helpers, each blocked on its own control socket. Launching a command
+*              sends the helper the argv, the resolved path and the flags, plus the redirection descriptors with SCM_RIGHTS. The
+*              helper sets up its process group, signals and descriptors and execs, so the command's pid is the helper's pid and
+*              it is reaped through the job table like any other child. The handoff replaces process creation on the critical
+*              path, the fork of a replacement helper happens at the next prompt. An empty pool falls back to the launch engine.
+* Citations:
+*         1. unix(7) and cmsg(3) Linux manual pages, Assisted with passing file descriptors over a socket.
+*/
+#ifndef shell_lite_pool_h
+#define shell_lite_pool_h
+
+#include "shell_lite_launch.h"
+#include <sys/socket.h>
+
+#define POOL_MAX 64                  //Largest SHELLLITE_POOL accepted
+#define POOL_MESSAGE_MAX 65536       //Largest argv a helper accepts, longer commands use the launch engine
+#define POOL_UNAVAILABLE -2          //Returned by poolLaunch when no helper is idle
+
+void initPool(void);    //Reads SHELLLITE_POOL and forks the helpers
+
+void refillPool(void);    //Forks helpers until the pool is full again
+
+void resetPool(void);    //Retires every idle helper, used when the shell's cwd changes
+
+void freePool(void);    //Retires every helper
+
+pid_t poolLaunch(struct launchPlan*);    //Starts plan in an idle helper, returns its pid, -1 on exec failure or POOL_UNAVAILABLE
+
+#endif /* shell_lite_pool_h */
@@ -0,0 +1,252 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_serve.c
+* Description: This is the function implementation file for the server mode of the shellLite shell. The server process only
+*              accepts connections, every connection is served by a forked child that sets up the same state main does and runs
+*              the client's lines through commandHandler. The captured output is sent with sendfile straight from the memfds.
+* Citations:
+*         1. unix(7) and memfd_create(2) Linux manual pages, Assisted with the listening socket and the output capture.
+*/
+#include "shell_lite_serve.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_input.h"
+#include "shell_lite_heredoc.h"
+
+/*            sendAll
+ * Description: Writes length bytes of text to fd, retrying short writes.
+ * Parameters: int fd, char* text, size_t length
+ * Returns: 0 on success, -1 on error
+ * Preconditions: fd >= 0, text != NULL
+ */
+static int sendAll(int fd, char* text, size_t length) {
+    ssize_t written;
+    while (length > 0) {
+        written = write(fd, text, length);
+        if (written == -1) {
+            if (errno == EINTR) { continue; }
+            return -1;
+        }
+        text += written;
+        length -= written;
+    }
+    return 0;
+}
+
+/*            sendCapture
+ * Description: Copies the first length bytes of the capture file fd to the socket with sendfile.
+ * Parameters: int conn, int fd, off_t length
+ * Returns: 0 on success, -1 on error
+ * Preconditions: conn >= 0, fd >= 0
+ */
+static int sendCapture(int conn, int fd, off_t length) {
+    off_t offset = 0;
+    ssize_t sent;
+
+    while (offset < length) {
+        sent = sendfile(conn, fd, &offset, length - offset);
+        if (sent == -1) {
+            if (errno == EINTR) { continue; }
+            return -1;
+        }
+        if (sent == 0) { return -1; }    //Capture shrank under us
+    }
+    return 0;
+}
+
+/*            sendFrame
+ * Description: Sends the frame for one command line: status and capture sizes, then the captured stdout and stderr.
+ * Parameters: int conn, struct process* lastForeground
+ * Returns: 0 on success, -1 if the client is gone
+ * Preconditions: conn >= 0, lastForeground != NULL, fds 1 and 2 are the capture memfds
+ */
+static int sendFrame(int conn, struct process* lastForeground) {
+    struct stat out, err;
+    char header[64];
+    int code = 0;    //Same value status reports, 0 before the first foreground command
+    int length;
+
+    if (lastForeground->signalValue >= 0) {
+        code = 128 + lastForeground->signalValue;
+    } else if (lastForeground->exitValue >= 0) {
+        code = lastForeground->exitValue;
+    }
+
+    if (fstat(1, &out) == -1 || fstat(2, &err) == -1) { return -1; }
+    length = snprintf(header, sizeof(header), "%d %lld %lld\n", code, (long long)out.st_size, (long long)err.st_size);
+    if (sendAll(conn, header, length) == -1) { return -1; }
+    if (sendCapture(conn, 1, out.st_size) == -1) { return -1; }
+    return sendCapture(conn, 2, err.st_size);
+}
+
+/*            serveClient
+ * Description: Body of the child serving one connection. fds 1 and 2 are replaced by memfds that are emptied before every line, stdin is
+ *         /dev/null so commands never read the socket. Runs until the client closes the socket or sends exit.
+ * Parameters: int conn
+ * Returns: never
+ * Preconditions: conn is a connected socket
+ */
+static void serveClient(int conn) {
+    struct lineReader reader;
+    struct process lastForeground;    //Per client status
+    struct jobTable jobs;             //Per client background jobs
+    struct arena lineArena;
+    struct sigaction action = {0};
+    char sPID[50];
+    char* line;
+    char** args;
+    ssize_t length;
+    int count = 0;
+    int exitFlag = 0;
+    int outFd = memfd_create("shellLite stdout", MFD_CLOEXEC);
+    int errFd = memfd_create("shellLite stderr", MFD_CLOEXEC);
+    int nullFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    if (outFd == -1 || errFd == -1 || nullFd == -1) { perror("memfd_create() error\n"); exit(1); }
+    if (dup2(nullFd, 0) == -1 || dup2(outFd, 1) == -1 || dup2(errFd, 2) == -1) { perror("dup2 capture fail!\n"); exit(1); }
+    close(nullFd);
+    setvbuf(stdout, NULL, _IOFBF, INPUT_BLOCK_SIZE);
+
+    action.sa_handler = SIG_DFL;
+    sigaction(SIGCHLD, &action, NULL);    //The server ignores it, the client's job table needs it
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &action, NULL);     //Like the interactive shell, only foreground commands react to SIGINT
+
+    sprintf(sPID, "%d", (int)getpid());
+    initLineReader(&reader, conn);
+    initProcess(&lastForeground);
+    initJobTable(&jobs);
+    initArena(&lineArena, ARENA_START_SIZE);
+
+    while (!exitFlag && (length = readLine(&reader, &line)) != 0) {
+        if (length == -1) {
+            if (errno == EINTR) { continue; }
+            break;
+        }
+
+        /* Empty the captures, commands share their file offsets with the shell */
+        ftruncate(1, 0);
+        lseek(1, 0, SEEK_SET);
+        ftruncate(2, 0);
+        lseek(2, 0, SEEK_SET);
+
+        arenaReset(&lineArena);
+        backgroundChecker(&jobs);
+        if (line[0] != '#') {
+            args = parseBuffer(line, length, sPID, &count, 1, &lineArena, &jobs);
+            if (count > 0) {
+                readHereDocuments(args, count, &reader, sPID, 0, &lineArena);    //Body lines are part of this line's frame
+                exitFlag = commandHandler(args, &count, &lastForeground, &jobs);
+            }
+        }
+        fflush(stdout);
+        fflush(stderr);
+
+        if (sendFrame(conn, &lastForeground) == -1) { break; }
+    }
+
+    if (!exitFlag) {
+        exitShell(&jobs);    //Client hung up, kill its background jobs like exit would
+    }
+    freeJobTable(&jobs);
+    freeArena(&lineArena);
+    freeLineReader(&reader);
+    close(conn);
+    exit(0);
+}
+
+/*            removeStaleSocket
+ * Description: Removes the socket file an earlier server left at address, one nothing is listening on. Any other file, or a socket a server still
+ *         accepts connections on, is left alone and reported.
+ * Parameters: struct sockaddr_un* address
+ * Returns: 0 if the path is free now, -1 if it must not be used
+ * Preconditions: address != NULL, address->sun_path is null terminated
+ */
+static int removeStaleSocket(struct sockaddr_un* address) {
+    struct stat info;
+    int probe;
+    int result;
+
+    if (lstat(address->sun_path, &info) == -1) {
+        if (errno == ENOENT) { return 0; }
+        perror("lstat() error\n");
+        return -1;
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        fprintf(stderr, "Error, %s exists and is not a socket\n", address->sun_path);
+        return -1;
+    }
+
+    probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe == -1) { perror("socket() error\n"); return -1; }
+    result = connect(probe, (struct sockaddr*)address, sizeof(*address));
+    close(probe);
+    if (result == 0) {
+        fprintf(stderr, "Error, a server is already listening on %s\n", address->sun_path);
+        return -1;
+    }
+    if (errno != ECONNREFUSED) {
+        perror("connect() error\n");
+        return -1;
+    }
+    if (unlink(address->sun_path) == -1) {
+        perror("unlink() error\n");
+        return -1;
+    }
+    return 0;
+}
+
+/*            serveCommands
+ * Description: This function runs server mode. It binds a Unix stream socket at path, replacing a stale socket file nothing listens on, and forks a
+ *         shell for every connection. Any other file at path is kept and the server does not start. Finished client shells are reaped by the kernel since the server ignores SIGCHLD.
+ * Parameters: char* path
+ * Returns: 1 if the socket could not be set up, does not return otherwise
+ * Preconditions: path != NULL
+ */
+int serveCommands(char* path) {
+    assert(path != NULL);
+
+    struct sockaddr_un address;
+    struct sigaction action = {0};
+    int listenFd, conn;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Error, socket path %s is too long\n", path);
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    if (removeStaleSocket(&address) == -1) { return 1; }
+    listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd == -1) { perror("socket() error\n"); return 1; }
+    if (bind(listenFd, (struct sockaddr*)&address, sizeof(address)) == -1 || listen(listenFd, SOMAXCONN) == -1) {
+        perror("bind() error\n");
+        close(listenFd);
+        return 1;
+    }
+
+    action.sa_handler = SIG_IGN;
+    sigaction(SIGCHLD, &action, NULL);    //Client shells need no status, let the kernel reap them
+
+    while (1) {
+        conn = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+        if (conn == -1) {
+            if (errno != EINTR) { perror("accept() error\n"); }
+            continue;
+        }
+
+        switch (fork()) {
+            case -1: {perror("Error with fork in serveCommands\n"); break;}
+
+            case 0: {
+                    close(listenFd);
+                    serveClient(conn);
+                }
+
+            default: break;
+        }
+        close(conn);
+    }
+}
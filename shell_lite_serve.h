@@ -0,0 +1,28 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_serve.h
+* Description: This is the function declaration file for the server mode of the shellLite shell. shellLite --serve path listens
+*              on a Unix stream socket and forks one shell per connection, so every client has its own cwd, job table and status.
+*              A client sends newline terminated command lines, each one is run through parseBuffer and commandHandler exactly like
+*              a line typed at the prompt, and answered with one frame:
+*                  "<status> <stdout bytes> <stderr bytes>\n" followed by the captured stdout, then the captured stderr
+*              status is what the status builtin would report after the line, 128 + n for a command killed by signal n. Output of
+*              the shell and of every command it starts is captured in two memfds that replace fds 1 and 2. Background completion
+*              messages are part of the stdout of the next line. exit or closing the socket ends the client's shell.
+* Citations:
+*         1. unix(7) and memfd_create(2) Linux manual pages, Assisted with the listening socket and the output capture.
+*/
+#ifndef shell_lite_serve_h
+#define shell_lite_serve_h
+
+#include "shell_lite_builtins.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
+
+int serveCommands(char*);    //Runs the server on a socket path, returns the exit status of the shell
+
+#endif /* shell_lite_serve_h */
@@ -0,0 +1,145 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_stats.c
+* Description: This is the function implementation file for the self-instrumentation of the shellLite shell. A sample of n
+*              nanoseconds goes into bucket floor(log2(n)), so percentiles are reported as the upper bound of their bucket
+*              (within a factor of two) while max is exact.
+* Citations:
+*         1. Gregg, Brendan "Systems Performance" 2.8 Statistics, Assisted with the log2 latency histograms.
+*/
+#include "shell_lite_stats.h"
+
+                            /* Struct holding the samples of one phase */
+struct histogram {
+    long long buckets[STATS_BUCKETS];    //Sample count per power of two
+    long long count;                     //Number of samples
+    long long max;                       //Largest sample in nanoseconds
+};
+
+static struct histogram phases[STATS_PHASES];    //One histogram per timed phase
+static long long counters[STATS_COUNTERS];       //Commands launched, background jobs reaped
+static const char* phaseNames[STATS_PHASES] = { "parse", "fork", "exec", "wait" };
+
+/*            statsNow
+ * Description: Returns the monotonic clock in nanoseconds.
+ * Parameters: void
+ * Returns: long long nanoseconds
+ * Preconditions: N/A
+ */
+long long statsNow(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*            statsRecord
+ * Description: Adds a sample of ns nanoseconds to the histogram of phase.
+ * Parameters: int phase, long long ns
+ * Returns: void
+ * Preconditions: 0 <= phase < STATS_PHASES
+ */
+void statsRecord(int phase, long long ns) {
+    struct histogram* h = &phases[phase];
+    if (ns < 1) { ns = 1; }
+
+    h->buckets[63 - __builtin_clzll((unsigned long long)ns)]++;
+    h->count++;
+    if (ns > h->max) { h->max = ns; }
+}
+
+/*            statsSince
+ * Description: Records the time since start under phase and returns the current time, so consecutive phases can be chained.
+ * Parameters: int phase, long long start
+ * Returns: long long current time in nanoseconds
+ * Preconditions: 0 <= phase < STATS_PHASES, start from statsNow
+ */
+long long statsSince(int phase, long long start) {
+    long long now = statsNow();
+    statsRecord(phase, now - start);
+    return now;
+}
+
+/*            statsCount
+ * Description: Increments counter.
+ * Parameters: int counter
+ * Returns: void
+ * Preconditions: 0 <= counter < STATS_COUNTERS
+ */
+void statsCount(int counter) {
+    counters[counter]++;
+}
+
+/*            percentile
+ * Description: Returns the upper bound of the bucket holding the pct percentile sample of h, never more than the max.
+ * Parameters: struct histogram* h, int pct
+ * Returns: long long nanoseconds
+ * Preconditions: h != NULL, h->count > 0
+ */
+static long long percentile(struct histogram* h, int pct) {
+    long long rank = (h->count * pct + 99) / 100;    //1 based rank of the sample
+    long long seen = 0;
+    int i;
+
+    for (i = 0; i < STATS_BUCKETS - 1; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) { break; }
+    }
+    if (i >= 62 || (2LL << i) > h->max) { return h->max; }
+    return 2LL << i;
+}
+
+/*            formatDuration
+ * Description: Writes ns into out in the largest unit that keeps it readable.
+ * Parameters: char* out, size_t size, long long ns
+ * Returns: out
+ * Preconditions: out != NULL
+ */
+static char* formatDuration(char* out, size_t size, long long ns) {
+    if (ns < 1000) {
+        snprintf(out, size, "%lldns", ns);
+    } else if (ns < 1000000) {
+        snprintf(out, size, "%.1fus", ns / 1e3);
+    } else if (ns < 1000000000) {
+        snprintf(out, size, "%.1fms", ns / 1e6);
+    } else {
+        snprintf(out, size, "%.2fs", ns / 1e9);
+    }
+    return out;
+}
+
+/*            statsCommand
+ * Description: The stats builtin. With no arguments prints count, p50, p99 and max of every phase followed by the counters, --reset clears them.
+ * Parameters: char** args, int count
+ * Returns: void
+ * Preconditions: args != NULL, count >= 1
+ */
+void statsCommand(char** args, int count) {
+    int i;
+    char p50[32], p99[32], max[32];
+
+    if (count > 1 && strcmp(args[1], "--reset") == 0) {
+        memset(phases, 0, sizeof(phases));
+        memset(counters, 0, sizeof(counters));
+        return;
+    }
+    if (count > 1) {
+        fprintf(stderr, "Usage: stats [--reset]\n");
+        return;
+    }
+
+    printf("%-8s %10s %10s %10s %10s\n", "phase", "count", "p50", "p99", "max");
+    for (i = 0; i < STATS_PHASES; i++) {
+        if (phases[i].count == 0) {
+            printf("%-8s %10d %10s %10s %10s\n", phaseNames[i], 0, "-", "-", "-");
+            continue;
+        }
+        printf("%-8s %10lld %10s %10s %10s\n", phaseNames[i], phases[i].count,
+               formatDuration(p50, sizeof(p50), percentile(&phases[i], 50)),
+               formatDuration(p99, sizeof(p99), percentile(&phases[i], 99)),
+               formatDuration(max, sizeof(max), phases[i].max));
+    }
+    printf("commands run: %lld\n", counters[STATS_COMMANDS]);
+    printf("background jobs reaped: %lld\n", counters[STATS_REAPED]);
+    printf("arena allocations: %ld\n", arenaAllocations());
+}
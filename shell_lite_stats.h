@@ -0,0 +1,41 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_stats.h
+* Description: This is the function declaration file for the self-instrumentation of the shellLite shell. The shell times its
+*              own work around every command with the monotonic clock and files each sample into a log2 bucketed histogram:
+*                  parse    readLine returning a line until parseBuffer has expanded and split it
+*                  fork     the fork, posix_spawn or pool helper handoff in the shell
+*                  exec     fork returning until the child has exec'd, reported by EOF on a close-on-exec pipe (fork engine only,
+*                           posix_spawn already returns after the child has exec'd so it is counted under fork)
+*                  wait     launch until the reaper collected a foreground command
+*              The stats builtin prints p50, p99 and max of every phase plus the command and reaped job counters, stats --reset
+*              clears them. Recording a sample is a clock read and three additions, no allocation.
+* Citations:
+*         1. Gregg, Brendan "Systems Performance" 2.8 Statistics, Assisted with the log2 latency histograms.
+*/
+#ifndef shell_lite_stats_h
+#define shell_lite_stats_h
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "shell_lite_arena.h"
+
+#define STATS_BUCKETS 64    //One bucket per power of two nanoseconds
+
+enum statsPhase { STATS_PARSE, STATS_FORK, STATS_EXEC, STATS_WAIT, STATS_PHASES };    //Timed phases of a command
+
+enum statsCounter { STATS_COMMANDS, STATS_REAPED, STATS_COUNTERS };    //Commands launched and background jobs reaped
+
+long long statsNow(void);    //Monotonic clock in nanoseconds
+
+long long statsSince(int, long long);    //Records now - start under phase, returns now
+
+void statsRecord(int, long long);    //Records a duration in nanoseconds under phase
+
+void statsCount(int);    //Increments a counter
+
+void statsCommand(char**, int);    //The stats builtin
+
+#endif /* shell_lite_stats_h */
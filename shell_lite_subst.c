@@ -0,0 +1,395 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_subst.c
+* Description: This is the function implementation file for command substitution in the shellLite shell. The command runs
+*              while the shell reads its output, the pipe is enlarged so a fast writer is switched out less often, and the
+*              output is collected in a buffer that doubles, so large outputs cost O(n) copying.
+* Citations:
+*         1. pipe(7) and fcntl(2) Linux manual pages, Assisted with pipe capacity.
+*/
+#include "shell_lite_subst.h"
+#include "shell_lite_launch.h"
+#include "shell_lite_jobs.h"
+#include "shell_lite_glob.h"
+#include "shell_lite_list.h"
+#include "shell_lite_pool.h"
+
+                            /* Struct for the words one argument expands to */
+struct wordBuffer {
+    char* text;          //Words separated by null terminators, malloc'd
+    size_t used;         //Bytes written to text
+    size_t capacity;     //Size of text
+    int words;           //Number of words in text
+    int inWord;          //1 while characters are being added to a word
+    int globbing;        //1 if a word may hold *, ? or [
+};
+
+/*            reserveWords
+ * Description: Makes room for length more bytes in buffer, doubling its text as needed.
+ * Parameters: struct wordBuffer* buffer, size_t length
+ * Returns: void
+ * Preconditions: buffer != NULL
+ */
+static void reserveWords(struct wordBuffer* buffer, size_t length) {
+    if (buffer->used + length <= buffer->capacity) { return; }
+    while (buffer->used + length > buffer->capacity) {
+        buffer->capacity *= 2;
+    }
+    buffer->text = realloc(buffer->text, buffer->capacity);
+    assert(buffer->text != NULL);
+}
+
+/*            addToWord
+ * Description: Appends length bytes of text to the current word of buffer, starting a word if there is none.
+ * Parameters: struct wordBuffer* buffer, char* text, size_t length
+ * Returns: void
+ * Preconditions: buffer != NULL, text != NULL
+ */
+static void addToWord(struct wordBuffer* buffer, char* text, size_t length) {
+    if (length == 0) { return; }
+    reserveWords(buffer, length + 1);    //Room for the terminator endWord adds
+    if (!buffer->inWord) { buffer->inWord = 1; buffer->words++; }
+    memcpy(buffer->text + buffer->used, text, length);
+    buffer->used += length;
+}
+
+/*            endWord
+ * Description: Ends the current word of buffer, if there is one.
+ * Parameters: struct wordBuffer* buffer
+ * Returns: void
+ * Preconditions: buffer != NULL
+ */
+static void endWord(struct wordBuffer* buffer) {
+    if (buffer->inWord) {
+        buffer->text[buffer->used++] = '\0';
+        buffer->inWord = 0;
+    }
+}
+
+/*            expandWord
+ * Description: Expands the argument word into buffer. Text outside the substitutions is copied, each $(...) is replaced by its command's output
+ *         trimmed of trailing newlines and split on spaces, tabs and newlines, so text next to it joins the first and last words of the output.
+ * Parameters: char* word, struct wordBuffer* buffer, char* pid, struct jobTable* jobs, struct arena* lineArena
+ * Returns: void
+ * Preconditions: word holds SUBST_MARK, a mark not followed by a closed (...) is copied as text
+ */
+static void expandWord(char* word, struct wordBuffer* buffer, char* pid, struct jobTable* jobs, struct arena* lineArena) {
+    char marks[2] = { SUBST_MARK, '\0' };
+    char breaks[5] = { ' ', '\t', '\n', SUBST_MARK, '\0' };
+    char* closing;
+    char* output;
+    char* next;
+    char* end;
+    size_t outLength, span;
+    int depth;
+
+    while (*word != '\0') {
+        if (*word != SUBST_MARK || word[1] != '(') {
+            span = strcspn(word + 1, marks) + 1;    //A mark without its ( is copied as text
+            addToWord(buffer, word, span);
+            word += span;
+            continue;
+        }
+
+        /* Same matching as the lexer, the command may hold parentheses and substitutions of its own */
+        depth = 1;
+        for (closing = word + 2; *closing != '\0'; closing++) {
+            if (*closing == '(') { depth++; }
+            if (*closing == ')' && --depth == 0) { break; }
+        }
+        if (*closing == '\0') {
+            addToWord(buffer, word, closing - word);    //Never closed, the lexer did not keep it, the rest is text
+            word = closing;
+            continue;
+        }
+
+        output = captureCommand(word + 2, closing - word - 2, pid, jobs, lineArena, &outLength);
+        if (output != NULL) {
+            while (outLength > 0 && output[outLength - 1] == '\n') {
+                output[--outLength] = '\0';    //Trailing newlines are trimmed, text after the $(...) joins the last word
+            }
+
+            if (strpbrk(output, "*?[") != NULL) { buffer->globbing = 1; }
+
+            /* Copy the output a word at a time, strspn and strcspn stop at the null terminator captureCommand adds. Every word
+             * but the last gives up a separator for its terminator, the word before the output and the last need two more bytes */
+            reserveWords(buffer, outLength + 2);
+            end = buffer->text + buffer->used;    //Write position
+            next = output;
+            while (next < output + outLength) {
+                span = strcspn(next, breaks);
+                if (span > 0) {
+                    if (!buffer->inWord) { buffer->inWord = 1; buffer->words++; }
+                    memcpy(end, next, span);
+                    end += span;
+                    next += span;
+                }
+                if (*next == ' ' || *next == '\t' || *next == '\n') {
+                    if (buffer->inWord) { *end++ = '\0'; buffer->inWord = 0; }    //Output is split into words
+                    next += strspn(next, " \t\n");
+                } else if (next < output + outLength) {
+                    next++;    //Null bytes and SUBST_MARK in the output are dropped
+                }
+            }
+            buffer->used = end - buffer->text;
+            free(output);
+        }
+        word = closing + 1;
+    }
+    endWord(buffer);
+}
+
+/*            hasSubstitution
+ * Description: This function checks whether any argument holds a $(...) the lexer kept for expandSubstitutions.
+ * Parameters: char** args, int count
+ * Returns: 1 if one does, 0 if not
+ * Preconditions: args != NULL
+ */
+int hasSubstitution(char** args, int count) {
+    assert(args != NULL);
+
+    int i;
+    for (i = 0; i < count; i++) {
+        if (strchr(args[i], SUBST_MARK) != NULL) { return 1; }
+    }
+    return 0;
+}
+
+/*            expandSubstitutions
+ * Description: This function runs the $(...) of one command, from left to right, and returns its new argument array allocated in lineArena.
+ *         Arguments holding a substitution are replaced by the words they expand to, symbols and $$ in the output are plain text. Words holding *, ?
+ *         or [ are expanded to the paths they match unless they follow a redirection, like the lexer's words. count is updated, to 0 if the
+ *         arguments exceed ARG_MAX.
+ * Parameters: char** args, int* count, char* pid, struct jobTable* jobs, struct arena* lineArena
+ * Returns: NULL terminated argument array
+ * Preconditions: args != NULL, count != NULL, pid != NULL, jobs != NULL, lineArena != NULL
+ */
+char** expandSubstitutions(char** args, int* count, char* pid, struct jobTable* jobs, struct arena* lineArena) {
+    assert(args != NULL && count != NULL && pid != NULL && jobs != NULL && lineArena != NULL);
+
+    struct wordBuffer buffer;
+    int capacity = *count + 1;    //Slots in result, grown when an argument expands to several words
+    int words = 0;                //Arguments in result
+    char** result = malloc(capacity * sizeof(char*));
+    char** expanded;
+    char* text;
+    size_t bytes = 0;             //Length of the arguments with their terminators, for the ARG_MAX check
+    size_t expandedBytes;
+    int expandedCount;
+    int i, j;
+
+    buffer.capacity = 256;
+    buffer.text = malloc(buffer.capacity);
+    assert(result != NULL && buffer.text != NULL);
+
+    for (i = 0; i < *count; i++) {
+        if (strchr(args[i], SUBST_MARK) == NULL) {
+            result[words++] = args[i];
+            bytes += strlen(args[i]) + 1;
+            continue;
+        }
+
+        buffer.used = 0;
+        buffer.words = 0;
+        buffer.inWord = 0;
+        buffer.globbing = strpbrk(args[i], "*?[") != NULL;    //May come from inside a $(...), expandGlobs checks every word again
+        expandWord(args[i], &buffer, pid, jobs, lineArena);
+
+        /* Move the words to the arena and point at them */
+        text = arenaAlloc(lineArena, buffer.used + 1);
+        memcpy(text, buffer.text, buffer.used);
+        expanded = arenaAlloc(lineArena, (buffer.words + 1) * sizeof(char*));
+        for (j = 0; j < buffer.words; j++) {
+            expanded[j] = text;
+            text += strlen(text) + 1;
+        }
+        expanded[buffer.words] = NULL;
+        expandedCount = buffer.words;
+        expandedBytes = buffer.used;
+        if (buffer.globbing && !(i > 0 && (args[i - 1][0] == '<' || args[i - 1][0] == '>'))) {    //Only the redirection symbols start with < or >
+            expanded = expandGlobs(expanded, &expandedCount, &expandedBytes, lineArena);
+        }
+
+        if (words + expandedCount + (*count - i) > capacity) {
+            capacity = (words + expandedCount + (*count - i)) * 2;
+            result = realloc(result, capacity * sizeof(char*));
+            assert(result != NULL);
+        }
+        memcpy(result + words, expanded, expandedCount * sizeof(char*));
+        words += expandedCount;
+        bytes += expandedBytes;
+    }
+    free(buffer.text);
+
+    expanded = arenaAlloc(lineArena, (words + 1) * sizeof(char*));
+    memcpy(expanded, result, words * sizeof(char*));
+    expanded[words] = NULL;
+    free(result);
+
+    *count = argumentsFit(bytes, words) ? words : 0;
+    return expanded;
+}
+
+/*            startCommand
+ * Description: Launches args, one command, with its stdout on a new capture pipe unless it redirects it with >.
+ * Parameters: char** args, int count, int* captureFds
+ * Returns: pid of the command, -1 if it could not be run. captureFds[0] is the read end, -1 when there is nothing to capture
+ * Preconditions: args != NULL, count > 0, captureFds != NULL
+ */
+static pid_t startCommand(char** args, int count, int* captureFds) {
+    struct launchPlan plan;
+    pid_t pid;
+
+    captureFds[0] = -1;
+    if (buildLaunchPlan(args, count, &plan) == -1) { return -1; }
+    if (plan.teeCount > 0) {
+        fprintf(stderr, "Error, >+ is not supported in $(...)\n");
+        closeLaunchPlan(&plan);
+        return -1;
+    }
+    if (plan.hereText != NULL && !plan.hereString) {
+        fprintf(stderr, "Error, here-documents are not supported in $(...), use <<<\n");
+        closeLaunchPlan(&plan);
+        return -1;
+    }
+    plan.pgid = -1;
+
+    if (openLaunchPlan(&plan) == -1) {
+        closeLaunchPlan(&plan);
+        return -1;
+    }
+    if (plan.outFd == -1) {    //Redirected with >, nothing to capture
+        if (pipe2(captureFds, O_CLOEXEC) == -1) {
+            perror("pipe() error\n");
+            captureFds[0] = -1;
+            closeLaunchPlan(&plan);
+            return -1;
+        }
+        fcntl(captureFds[1], F_SETPIPE_SZ, SUBST_PIPE_SIZE);    //Best effort, the default 64 KB still works
+        plan.outFd = captureFds[1];
+    }
+
+    pid = launchCommand(&plan);
+    closeLaunchPlan(&plan);    //Closes the shell's write end, EOF arrives when the command exits
+    if (pid == -1 && captureFds[0] != -1) {
+        close(captureFds[0]);
+        captureFds[0] = -1;
+    }
+    return pid;
+}
+
+/*            startSubshell
+ * Description: Forks a copy of the shell that runs args through commandHandler with its stdout on a new capture pipe, so pipelines and
+ *         lists work inside $(...). The copy has a job table of its own and launches without the helper pool, whose helpers belong to the
+ *         shell. It exits with the status of its last foreground command.
+ * Parameters: char** args, int count, struct jobTable* jobs, int* captureFds
+ * Returns: pid of the copy, -1 if it could not be started. captureFds[0] is the read end, -1 on failure
+ * Preconditions: args != NULL, count > 0, jobs != NULL, captureFds != NULL
+ */
+static pid_t startSubshell(char** args, int count, struct jobTable* jobs, int* captureFds) {
+    struct jobTable subshellJobs;
+    struct process last;
+    pid_t pid;
+
+    captureFds[0] = -1;
+    if (linearSearch(args, "<<", count) > -1) {
+        fprintf(stderr, "Error, here-documents are not supported in $(...), use <<<\n");
+        return -1;
+    }
+    if (pipe2(captureFds, O_CLOEXEC) == -1) {
+        perror("pipe() error\n");
+        captureFds[0] = -1;
+        return -1;
+    }
+    fcntl(captureFds[1], F_SETPIPE_SZ, SUBST_PIPE_SIZE);
+
+    fflush(stdout);    //The copy would write the shell's buffered output again
+    fflush(stderr);
+    pid = fork();
+    if (pid != 0) {
+        if (pid == -1) {
+            perror("fork() error\n");
+            close(captureFds[0]);
+            captureFds[0] = -1;
+        }
+        close(captureFds[1]);    //EOF arrives when the copy and every command holding the pipe exit
+        return pid;
+    }
+
+    dup2(captureFds[1], STDOUT_FILENO);
+    close(captureFds[0]);
+    close(captureFds[1]);
+    freePool();
+    close(jobs->sigFd);
+    initJobTable(&subshellJobs);
+    subshellJobs.foregroundOnly = jobs->foregroundOnly;
+    initProcess(&last);
+    commandHandler(args, &count, &last, &subshellJobs);
+    fflush(stdout);
+    freeJobTable(&subshellJobs);
+    _exit(last.signalValue >= 0 ? 128 + last.signalValue : (last.exitValue > 0 ? last.exitValue : 0));
+}
+
+/*            captureCommand
+ * Description: This function parses command, the text between $( and ), launches it with its stdout on a pipe and reads the pipe to EOF.
+ *         A single command is launched directly, its own $$ and $(...) are expanded first. A pipeline or list runs in a copy of the shell
+ *         forked by startSubshell, the copy expands each command's $(...) when it runs. A trailing & is ignored, the shell needs the output now.
+ *         A command whose output is redirected with > captures nothing. The child is tracked before the shell reads so it is reaped like any
+ *         foreground command, its status does not change the status builtin's.
+ * Parameters: char* command, size_t length, char* pid, struct jobTable* jobs, struct arena* lineArena, size_t* outLength
+ * Returns: malloc'd output of the command, *outLength bytes long and null terminated, NULL if it could not be run
+ * Preconditions: command != NULL, pid != NULL, jobs != NULL, lineArena != NULL, outLength != NULL
+ */
+char* captureCommand(char* command, size_t length, char* pid, struct jobTable* jobs, struct arena* lineArena, size_t* outLength) {
+    assert(command != NULL && pid != NULL && jobs != NULL && lineArena != NULL && outLength != NULL);
+
+    struct process child;
+    char** args;
+    char* output;
+    size_t capacity = SUBST_START_SIZE;
+    ssize_t numRead;
+    int count = 0;
+    int captureFds[2];
+
+    *outLength = 0;
+    args = parseBuffer(command, length, pid, &count, 1, lineArena, jobs);
+    if (count > 0 && strcmp(args[count - 1], "&") == 0) {
+        args[--count] = NULL;
+    }
+    if (count == 0) { return NULL; }
+
+    initProcess(&child);
+    if (linearSearch(args, "|", count) > -1 || findListOperator(args, count) > -1) {
+        child.pid = startSubshell(args, count, jobs, captureFds);
+    } else {
+        if (hasSubstitution(args, count)) {
+            args = expandSubstitutions(args, &count, pid, jobs, lineArena);    //Nested $(...) run before this command
+            if (count == 0) { return NULL; }
+        }
+        child.pid = startCommand(args, count, captureFds);
+    }
+    if (child.pid == -1) { return NULL; }
+    trackProcess(jobs, &child);
+
+    output = malloc(capacity);
+    assert(output != NULL);
+    while (captureFds[0] != -1) {
+        if (*outLength + 1 >= capacity) {    //Room for the null terminator
+            capacity *= 2;
+            output = realloc(output, capacity);
+            assert(output != NULL);
+        }
+        numRead = read(captureFds[0], output + *outLength, capacity - *outLength);
+        if (numRead > 0) {
+            *outLength += numRead;
+        } else if (numRead == 0 || errno != EINTR) {
+            close(captureFds[0]);
+            captureFds[0] = -1;
+        }
+    }
+
+    output[*outLength] = '\0';
+    waitForCommand(jobs, &child);
+    return output;
+}
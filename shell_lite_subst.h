@@ -0,0 +1,27 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_subst.h
+* Description: This is the function declaration file for command substitution in the shellLite shell. $(command args...) is
+*              replaced by the output of the command, split into arguments on spaces, tabs and newlines, so trailing newlines
+*              disappear. A single command is started by the launch engine with its stdout on a pipe enlarged with F_SETPIPE_SZ,
+*              a pipeline or list runs in a forked copy of the shell writing to that pipe. The lexer keeps each $(...) in its word and
+*              expandSubstitutions runs it when the command holding it runs, so a list element skipped by && or || runs nothing.
+* Citations:
+*         1. pipe(7) and fcntl(2) Linux manual pages, Assisted with pipe capacity.
+*/
+#ifndef shell_lite_subst_h
+#define shell_lite_subst_h
+
+#include "shell_lite_builtins.h"
+
+#define SUBST_PIPE_SIZE 1048576    //Requested pipe capacity, the default /proc/sys/fs/pipe-max-size
+#define SUBST_START_SIZE 65536     //Initial size of the capture buffer, doubled as needed
+
+char* captureCommand(char*, size_t, char*, struct jobTable*, struct arena*, size_t*);    //Runs a command and returns its output in a malloc'd buffer
+
+int hasSubstitution(char**, int);    //Returns 1 if an argument holds a $(...) waiting to run
+
+char** expandSubstitutions(char**, int*, char*, struct jobTable*, struct arena*);    //Runs a command's $(...) and returns its expanded arguments
+
+#endif /* shell_lite_subst_h */
@@ -0,0 +1,256 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_trace.c
+* Description: This is the function implementation file for the timeline tracer of the shellLite shell. Spans are complete ("X")
+*              events with microsecond timestamps from the monotonic clock. The file is a JSON array, which the trace viewers also
+*              accept without its closing bracket, so a shell that is killed leaves a usable trace up to its last buffer write.
+*              argv[0] of running commands is kept in an open addressing table keyed by pid until they are reaped.
+* Citations:
+*         1. "Trace Event Format" Google document, Assisted with the JSON event layout.
+*         2. Knuth, Donald "The Art of Computer Programming" Vol. 3 6.4 Algorithm R, Assisted with deleting from linear probing.
+*/
+#include "shell_lite_trace.h"
+#undef traceEnabled    //Only the trace points of the other files become 0 with SHELLLITE_NO_TRACE
+
+                            /* Struct for a command whose lifetime is being traced */
+struct traceName {
+    pid_t pid;                      //0 for an empty slot
+    long long launched;             //Start of the launch, in statsNow nanoseconds
+    char name[TRACE_NAME_MAX];      //argv[0], escaped for JSON
+};
+
+int traceEnabled = 0;
+
+static int traceFd = -1;                       //SHELLLITE_TRACE file
+static char traceBuffer[TRACE_BUFFER_SIZE];    //Events not written yet
+static size_t traceUsed = 0;                   //Bytes in traceBuffer
+static int traceEvents = 0;                    //Events written, the first one has no leading comma
+static pid_t tracePid = 0;                     //Shell pid, the trace's process and the shell's track
+static struct traceName* names = NULL;         //Running commands by pid
+static int nameSlots = 0;                      //Size of names, a power of two
+static int nameCount = 0;                      //Used slots
+
+/*            traceFlush
+ * Description: Writes the buffered events to the trace file.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: traceFd is open
+ */
+static void traceFlush(void) {
+    size_t done = 0;
+    ssize_t written;
+
+    while (done < traceUsed) {
+        written = write(traceFd, traceBuffer + done, traceUsed - done);
+        if (written == -1) {
+            if (errno == EINTR) { continue; }
+            perror("trace write() error\n");
+            break;
+        }
+        done += written;
+    }
+    traceUsed = 0;
+}
+
+/*            traceEvent
+ * Description: Appends one formatted event to the buffer, writing the buffer out first if the event does not fit.
+ * Parameters: const char* format, ...
+ * Returns: void
+ * Preconditions: traceEnabled
+ */
+static void traceEvent(const char* format, ...) {
+    char event[512];
+    va_list list;
+    int length;
+
+    va_start(list, format);
+    length = vsnprintf(event, sizeof(event), format, list);
+    va_end(list);
+    if (length < 0) { return; }
+    if (length >= (int)sizeof(event)) { length = sizeof(event) - 1; }
+
+    if (traceUsed + length + 2 > TRACE_BUFFER_SIZE) { traceFlush(); }
+    if (traceEvents++ > 0) { traceBuffer[traceUsed++] = ','; }
+    memcpy(traceBuffer + traceUsed, event, length);
+    traceUsed += length;
+    traceBuffer[traceUsed++] = '\n';
+}
+
+/*            escapeName
+ * Description: Copies text into name as the inside of a JSON string, cut at TRACE_NAME_MAX - 1 bytes.
+ * Parameters: char* name, char* text
+ * Returns: void
+ * Preconditions: name holds TRACE_NAME_MAX bytes, text != NULL
+ */
+static void escapeName(char* name, char* text) {
+    size_t used = 0;
+    unsigned char c;
+
+    for (; *text != '\0'; text++) {
+        c = (unsigned char)*text;
+        if (c == '"' || c == '\\') {
+            if (used + 3 > TRACE_NAME_MAX) { break; }
+            name[used++] = '\\';
+            name[used++] = c;
+        } else if (c < 0x20) {
+            if (used + 7 > TRACE_NAME_MAX) { break; }
+            used += sprintf(name + used, "\\u%04x", c);
+        } else {
+            if (used + 2 > TRACE_NAME_MAX) { break; }
+            name[used++] = c;
+        }
+    }
+    name[used] = '\0';
+}
+
+/*            findName
+ * Description: Returns the slot of pid in the name table, or the empty slot where it would go.
+ * Parameters: pid_t pid
+ * Returns: slot index
+ * Preconditions: nameSlots > 0, the table has an empty slot
+ */
+static int findName(pid_t pid) {
+    int i = (unsigned)pid * 2654435761u & (nameSlots - 1);
+    while (names[i].pid != 0 && names[i].pid != pid) {
+        i = (i + 1) & (nameSlots - 1);
+    }
+    return i;
+}
+
+/*            initTrace
+ * Description: This function opens the file named by SHELLLITE_TRACE, truncating it, and starts the JSON array. Without the variable tracing stays off.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: Called once, before any command is launched
+ */
+void initTrace(void) {
+    char* path = getenv("SHELLLITE_TRACE");
+    if (path == NULL || path[0] == '\0') { return; }
+
+    traceFd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (traceFd == -1) { perror("trace open() error\n"); return; }
+
+    nameSlots = 64;
+    names = calloc(nameSlots, sizeof(struct traceName));
+    assert(names != NULL);
+    tracePid = getpid();
+    traceEnabled = 1;
+
+    traceBuffer[traceUsed++] = '[';
+    traceBuffer[traceUsed++] = '\n';
+    traceEvent("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"shellLite\"}}", tracePid, tracePid);
+    traceEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"shell\"}}", tracePid, tracePid);
+}
+
+/*            freeTrace
+ * Description: This function closes the JSON array, writes out the buffer and turns tracing off.
+ * Parameters: void
+ * Returns: void
+ * Preconditions: N/A
+ */
+void freeTrace(void) {
+    if (!traceEnabled) { return; }
+
+    traceBuffer[traceUsed++] = ']';    //traceEvent always leaves room for two bytes
+    traceBuffer[traceUsed++] = '\n';
+    traceFlush();
+    close(traceFd);
+    traceFd = -1;
+    traceEnabled = 0;
+    free(names);
+    names = NULL;
+}
+
+/*            traceSpan
+ * Description: This function records a span of the shell's own work from start to end, in statsNow nanoseconds. A pid > 0 is added to the
+ *         arguments, with the argv[0] traceLaunch remembered for it while the command has not been reaped.
+ * Parameters: const char* name, long long start, long long end, pid_t pid
+ * Returns: void
+ * Preconditions: traceEnabled, name is plain JSON text
+ */
+void traceSpan(const char* name, long long start, long long end, pid_t pid) {
+    int i;
+
+    if (pid <= 0) {
+        traceEvent("{\"name\":\"%s\",\"cat\":\"shell\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d}",
+                   name, start / 1000, start % 1000, (end - start) / 1000, (end - start) % 1000, tracePid, tracePid);
+        return;
+    }
+    i = findName(pid);
+    if (names[i].pid != pid) {
+        /* Reaped already, the pid leads to the command's own track */
+        traceEvent("{\"name\":\"%s\",\"cat\":\"shell\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d,"
+                   "\"args\":{\"pid\":%d}}", name, start / 1000, start % 1000, (end - start) / 1000, (end - start) % 1000,
+                   tracePid, tracePid, (int)pid);
+        return;
+    }
+    traceEvent("{\"name\":\"%s\",\"cat\":\"shell\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d,"
+               "\"args\":{\"pid\":%d,\"argv0\":\"%s\"}}", name, start / 1000, start % 1000, (end - start) / 1000, (end - start) % 1000,
+               tracePid, tracePid, (int)pid, names[i].name);
+}
+
+/*            traceLaunch
+ * Description: This function remembers argv[0] and the launch time of a command that was just started and names its track in the trace.
+ * Parameters: pid_t pid, char* argv0, long long launched
+ * Returns: void
+ * Preconditions: traceEnabled, pid > 0, argv0 != NULL, launched from statsNow
+ */
+void traceLaunch(pid_t pid, char* argv0, long long launched) {
+    struct traceName* old;
+    int oldSlots, i;
+
+    if (2 * (nameCount + 1) > nameSlots) {
+        /* Grow and reinsert */
+        old = names;
+        oldSlots = nameSlots;
+        nameSlots *= 2;
+        names = calloc(nameSlots, sizeof(struct traceName));
+        assert(names != NULL);
+        for (i = 0; i < oldSlots; i++) {
+            if (old[i].pid != 0) { names[findName(old[i].pid)] = old[i]; }
+        }
+        free(old);
+    }
+
+    i = findName(pid);
+    if (names[i].pid != pid) { nameCount++; }
+    names[i].pid = pid;
+    names[i].launched = launched;
+    escapeName(names[i].name, argv0);
+    traceEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+               tracePid, (int)pid, names[i].name, (int)pid);
+}
+
+/*            traceExit
+ * Description: This function records the lifetime of reaped process p, from its launch to its reap, on its own track with its exit value or
+ *         signal, and forgets its argv[0].
+ * Parameters: struct process* p
+ * Returns: void
+ * Preconditions: traceEnabled, p != NULL, p->done
+ */
+void traceExit(struct process* p) {
+    long long end = p->end.tv_sec * 1000000000LL + p->end.tv_nsec;
+    long long start;
+    int i = findName(p->pid);
+    int j, k;
+
+    if (names[i].pid != p->pid) { return; }    //Started before tracing or not through launchCommand
+    start = names[i].launched;
+    traceEvent("{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld.%03lld,\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d,"
+               "\"args\":{\"pid\":%d,\"%s\":%d}}", names[i].name, p->background ? "background" : "foreground",
+               start / 1000, start % 1000, (end - start) / 1000, (end - start) % 1000, tracePid, (int)p->pid, (int)p->pid,
+               p->signalValue >= 0 ? "signal" : "exit", p->signalValue >= 0 ? p->signalValue : p->exitValue);
+
+    /* Remove the slot and move later entries of the same run back into the hole */
+    names[i].pid = 0;
+    nameCount--;
+    for (j = (i + 1) & (nameSlots - 1); names[j].pid != 0; j = (j + 1) & (nameSlots - 1)) {
+        k = (unsigned)names[j].pid * 2654435761u & (nameSlots - 1);
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+            names[i] = names[j];
+            names[j].pid = 0;
+            i = j;
+        }
+    }
+}
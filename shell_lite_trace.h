@@ -0,0 +1,41 @@
+/* Author: David Eaton
+* Date: 05/07/2020
+* Last Revised: 10/18/2026
+* File Name: shell_lite_trace.h
+* Description: This is the function declaration file for the timeline tracer of the shellLite shell. With SHELLLITE_TRACE=file
+*              in the environment the shell writes Chrome trace-event JSON, loadable in Perfetto or chrome://tracing:
+*                  parse, fork, exec-start and wait    spans of the shell itself, on the shell's track
+*                  argv[0] of every command            its lifetime from launch to reap, on a track of its own, with pid and status
+*              Events go through a 64 KB buffer that is written out when full and at exit. Every trace point is guarded by
+*              traceEnabled, so a shell without SHELLLITE_TRACE pays one branch per point. Built with -DSHELLLITE_NO_TRACE
+*              the points are compiled out, bench/trace.sh compares the two.
+* Citations:
+*         1. "Trace Event Format" Google document, Assisted with the JSON event layout.
+*/
+#ifndef shell_lite_trace_h
+#define shell_lite_trace_h
+
+#include "shell_lite_builtins.h"
+#include <errno.h>
+#include <stdarg.h>
+
+#define TRACE_BUFFER_SIZE 65536    //Bytes buffered before a write
+#define TRACE_NAME_MAX 64          //Longest argv[0] kept for a command's track
+
+extern int traceEnabled;    //1 while SHELLLITE_TRACE is being written
+
+#ifdef SHELLLITE_NO_TRACE
+#define traceEnabled 0      //Baseline build of bench/trace.sh, every trace point compiles away
+#endif
+
+void initTrace(void);    //Opens the SHELLLITE_TRACE file if it is set
+
+void freeTrace(void);    //Ends the JSON array and writes out the buffer
+
+void traceSpan(const char*, long long, long long, pid_t);    //Records a span of the shell itself
+
+void traceLaunch(pid_t, char*, long long);    //Remembers argv[0] and launch time of a started command
+
+void traceExit(struct process*);    //Records the lifetime of a reaped command
+
+#endif /* shell_lite_trace_h */
@@ -0,0 +1,32 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: exit_kills_jobs.sh
+# Description: Checks that exit kills every job. The script starts TEST_EXIT_JOBS background jobs (5000 by default): plain sleeps,
+#              two stage pipelines and sh scripts that start a sleep of their own, then exits. No sleep may be left afterwards
+#              and the shell must be gone within EXIT_BOUND_MS (3000 by default) of the exit line.
+
+. "$(dirname "$0")/../bench/common.sh"
+
+JOBS=${TEST_EXIT_JOBS:-5000}
+BOUND=${EXIT_BOUND_MS:-3000}
+MARK=1017.5    # sleep time that names this test's jobs
+
+echo "sleep $MARK & sleep $MARK" > grandchild.sh
+awk -v n="$JOBS" -v mark="$MARK" 'BEGIN {
+    for (i = 0; i < n; i++) {
+        if (i % 10 == 1) { print "sleep " mark " | sleep " mark " &" }
+        else if (i % 10 == 2) { print "sh grandchild.sh &" }
+        else { print "sleep " mark " &" }
+    }
+    print "/bin/date +%s%N > stamp"
+    print "exit"
+}' > jobs.sh
+
+"$SHELLLITE" -f jobs.sh > /dev/null 2>&1
+took=$(( ($(nowNs) - $(cat stamp)) / 1000000 ))
+left=$(pgrep -c -x -f "sleep $MARK")
+
+report "$JOBS jobs, exit line to shell gone" "$took" ms
+[ "$left" -eq 0 ] || { pkill -x -f "sleep $MARK"; fail "$left sleeps outlived the shell"; }
+[ "$took" -le "$BOUND" ] || fail "exit took $took ms, bound $BOUND ms"
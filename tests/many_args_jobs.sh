@@ -0,0 +1,29 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: many_args_jobs.sh
+# Description: Checks that lines and the job table have no fixed limits. A command gets TEST_ARGS arguments (100000 by default),
+#              once exec'd and once in the shell's echo, then TEST_JOBS background jobs (20000 by default) run at the same time:
+#              jobs must list every one of them, and exit must leave none behind.
+
+. "$(dirname "$0")/../bench/common.sh"
+
+ARGS=${TEST_ARGS:-100000}
+JOBS=${TEST_JOBS:-20000}
+MARK=1014.5    # sleep time that names this test's jobs
+
+awk -v n="$ARGS" 'BEGIN {
+    printf "/bin/echo"; for (i = 1; i <= n; i++) { printf " a%d", i }; print ""
+    printf "echo";      for (i = 1; i <= n; i++) { printf " a%d", i }; print ""
+}' > args.sh
+words=$("$SHELLLITE" -f args.sh | wc -w)
+[ "$words" -eq $((ARGS * 2)) ] || fail "$ARGS arguments twice printed $words words, expected $((ARGS * 2))"
+
+awk -v n="$JOBS" -v mark="$MARK" 'BEGIN {
+    for (i = 0; i < n; i++) { print "sleep " mark " &" }
+    print "jobs"
+}' > jobs.sh
+running=$("$SHELLLITE" -f jobs.sh 2>&1 | grep -c '^\[[0-9]*\] Running')
+left=$(pgrep -c -x -f "sleep $MARK")
+[ "$running" -eq "$JOBS" ] || fail "jobs listed $running running jobs, expected $JOBS"
+[ "$left" -eq 0 ] || { pkill -x -f "sleep $MARK"; fail "$left jobs outlived the shell"; }
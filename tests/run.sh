@@ -0,0 +1,21 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: run.sh
+# Description: Runs every test script in tests/, or the ones named on the command line, and exits with status 1 if any of them
+#              fails. Used by make test, the scripts share the helpers of bench/common.sh.
+
+cd "$(dirname "$0")" || exit 1
+failed=0
+if [ $# -eq 0 ]; then
+    set -- $(ls *.sh | grep -v '^run\.sh$')
+fi
+for script in "$@"; do
+    if sh "./$script"; then
+        echo "PASS $script"
+    else
+        echo "FAIL $script"
+        failed=$((failed + 1))
+    fi
+done
+[ $failed -eq 0 ] || { echo "$failed test(s) failed" >&2; exit 1; }
@@ -0,0 +1,27 @@
+# Author: David Eaton
+# Date: 05/07/2020
+# Last Revised: 10/18/2026
+# File Name: subst_timing.sh
+# Description: Checks that $(...) runs when the command holding it runs: not at all in a list element that && or || skips, and
+#              after the earlier elements of its line. Nesting, words glued to the output and globbing the output still work, and
+#              pipelines and lists inside $(...) run in a copy of the shell.
+
+. "$(dirname "$0")/../bench/common.sh"
+
+touch p1.c p2.c
+echo 'p*.c' > pattern
+cat > script.sh <<'SCRIPT'
+false && echo $(touch skipped)
+true || echo $(touch skipped)
+echo hi > f ; echo $(cat f)
+echo $(echo $(echo nested))
+echo x$(echo a b)y
+echo $(cat pattern)
+echo $(echo a b c | wc -w) $(false || echo b ; echo c)
+false && echo $(touch skipped | cat)
+SCRIPT
+printf 'hi\nnested\nxa by\np1.c p2.c\n3 b c\n' > expected
+
+"$SHELLLITE" -f script.sh > got 2>&1
+[ ! -e skipped ] || fail "a skipped list element ran its \$(...)"
+cmp -s got expected || { diff expected got >&2; fail "substitutions printed something else"; }